@@ -1,6 +1,8 @@
 #include "Application.h"
 #include <finproj/curves/CDS.h>
+#include <finproj/curves/CurveSnapshot.h>
 #include <finproj/utils/Misc.h>
+#include <filesystem>
 namespace plt = matplotlibcpp;
 
 IborSwap Application::create_swap(const ChronoDate& val_date, const ChronoDate& maturity_date, double swap_rate){
@@ -59,8 +61,17 @@ IborSingleCurve Application::build_swap_curve(const ChronoDate& val_date, std::s
 std::vector<CreditCurve> Application::build_credit_curves(const ChronoDate& val_date, const std::string&& spreads_file,
                                              const IborSingleCurve& libor_curve, double recovery_rate)
 {
-  std::vector<CDS> cds_contracts{};
   std::vector<CreditCurve> credit_curves{};
+  for (const auto& [ticker, cds_contracts] : read_cds_contracts(val_date, spreads_file))
+    credit_curves.emplace_back(CreditCurve(val_date,ticker, cds_contracts,libor_curve,recovery_rate));
+  return credit_curves;
+}
+
+std::vector<std::pair<std::string, std::vector<CDS>>> Application::read_cds_contracts(const ChronoDate& val_date,
+                                                                                      const std::string& spreads_file) const
+{
+  std::vector<CDS> cds_contracts{};
+  std::vector<std::pair<std::string, std::vector<CDS>>> contracts{};
   std::ifstream fcurve;
   fcurve.open(spreads_file);
   if (fcurve.fail())
@@ -96,9 +107,49 @@ std::vector<CreditCurve> Application::build_credit_curves(const ChronoDate& val_
     getline(input_string,temp,',');
     cds_contracts.emplace_back(CDS(val_date, "30Y", std::stod(temp)));
 
-    credit_curves.emplace_back(CreditCurve(val_date,ticker, cds_contracts,libor_curve,recovery_rate));
+    contracts.emplace_back(ticker, cds_contracts);
   }
-  return credit_curves;
+  return contracts;
+}
+
+std::optional<std::tuple<IborSingleCurve, std::vector<CreditCurve>>> Application::load_curves(const ChronoDate& val_date,
+    const std::string& snapshot_file, const std::string& swap_file, const std::string& spreads_file, double recovery_rate) const
+{
+  namespace fs = std::filesystem;
+  std::error_code snapshot_ec, swap_ec, spreads_ec;
+  auto snapshot_time = fs::last_write_time(snapshot_file, snapshot_ec);
+  auto swap_time = fs::last_write_time(swap_file, swap_ec);
+  auto spreads_time = fs::last_write_time(spreads_file, spreads_ec);
+  if (snapshot_ec || swap_ec || spreads_ec || snapshot_time < swap_time || snapshot_time < spreads_time)
+    return std::nullopt;
+  try {
+    CurveSnapshot snapshot(snapshot_file);
+    const auto* libor_view = snapshot.find(CurveView::Kind::DISCOUNT, "libor");
+    if (libor_view == nullptr || libor_view->valuation_date() != val_date)
+      return std::nullopt;
+    IborSingleCurve libor_curve(*libor_view);
+    std::vector<CreditCurve> credit_curves{};
+    for (const auto& [ticker, cds_contracts] : read_cds_contracts(val_date, spreads_file)) {
+      const auto* view = snapshot.find(CurveView::Kind::SURVIVAL, ticker);
+      if (view == nullptr || view->valuation_date() != val_date || view->recovery_rate() != recovery_rate)
+        return std::nullopt;
+      credit_curves.emplace_back(*view, libor_curve, cds_contracts);
+    }
+    return std::make_tuple(std::move(libor_curve), std::move(credit_curves));
+  } catch (const std::runtime_error& ex) {
+    std::cerr << "Ignoring curve snapshot " << snapshot_file << ": " << ex.what() << std::endl;
+    return std::nullopt;
+  }
+}
+
+void Application::save_curves(const std::string& snapshot_file, const IborSingleCurve& libor_curve,
+                              const std::vector<CreditCurve>& ccurves) const
+{
+  CurveSnapshotWriter writer{};
+  writer.add(libor_curve, "libor");
+  for (const auto& curve : ccurves)
+    writer.add(curve);
+  writer.write(snapshot_file);
 }
 
 void Application::plot_discount_curve(const IborSingleCurve& curve, const std::string& filename) const {
@@ -122,17 +173,16 @@ void Application::plot_surv_prob_curves(const ChronoDate& val_date,const std::ve
   plt::figure();
   for (auto& curve : ccurves){
     auto years = linspace(0.0,10.0,40);
-    std::vector<double> surv_probs{};
+    std::vector<ChronoDate> dates{};
+    for (auto year : years){
+      dates.push_back(val_date.add_years(year));
+    }
+    auto surv_probs = curve.surv_prob(dates);
     std::vector<double> hazard_rates{};
     hazard_rates.push_back(0.0);
-    for (size_t y{0}; y < years.size(); ++y){
-      auto date = val_date.add_years(years[y]);
-      auto q = curve.surv_prob(date);
-      surv_probs.push_back(q);
-      if (y > 0){
-        auto h = -log(surv_probs[y]/surv_probs[y-1])/(years[y] - years[y-1]);
-        hazard_rates.push_back(h);
-      }
+    for (size_t y{1}; y < years.size(); ++y){
+      auto h = -log(surv_probs[y]/surv_probs[y-1])/(years[y] - years[y-1]);
+      hazard_rates.push_back(h);
     }
     plt::plot(years, surv_probs, {{"label", curve.ticker_}});
   }
@@ -147,17 +197,16 @@ void Application::plot_hazard_curves(const ChronoDate& val_date,const std::vecto
   plt::figure();
   for (auto& curve : ccurves){
     auto years = linspace(0.0,10.0,40);
-    std::vector<double> surv_probs{};
+    std::vector<ChronoDate> dates{};
+    for (auto year : years){
+      dates.push_back(val_date.add_years(year));
+    }
+    auto surv_probs = curve.surv_prob(dates);
     std::vector<double> hazard_rates{};
     hazard_rates.push_back(0.0);
-    for (size_t y{0}; y < years.size(); ++y){
-      auto date = val_date.add_years(years[y]);
-      auto q = curve.surv_prob(date);
-      surv_probs.push_back(q);
-      if (y > 0){
-        auto h = -log(surv_probs[y]/surv_probs[y-1])/(years[y] - years[y-1]);
-        hazard_rates.push_back(h);
-      }
+    for (size_t y{1}; y < years.size(); ++y){
+      auto h = -log(surv_probs[y]/surv_probs[y-1])/(years[y] - years[y-1]);
+      hazard_rates.push_back(h);
     }
     plt::plot(years, hazard_rates, {{"label", curve.ticker_}});
   }
@@ -9,8 +9,10 @@
 #include <finproj/matplot/matplotlibcpp.h>
 #include <finproj/utils/ChronoDate.h>
 #include <finproj/curves/CreditCurve.h>
+#include <finproj/curves/CDS.h>
 #include <fstream>
 #include <iostream>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -45,6 +47,14 @@ class Application {
   IborSwap create_swap(const ChronoDate& val_date, const ChronoDate& maturity_date, double swap_rate);
   IborSingleCurve build_swap_curve(const ChronoDate& val_date, std::string&& data_file, InterpTypes interp);
   std::vector<CreditCurve> build_credit_curves(const ChronoDate& val_date, const std::string&& spreads_file, const IborSingleCurve& libor_curve, double recovery_rate);
+  /** CDS contracts per ticker, in file order, from a spreads file. */
+  std::vector<std::pair<std::string, std::vector<CDS>>> read_cds_contracts(const ChronoDate& val_date, const std::string& spreads_file) const;
+  /** Curves from a snapshot written by save_curves, or nothing when the snapshot is
+  missing, older than either data file or built for another date, recovery or set of
+  tickers. The credit curves get their contracts back for the bumped curves. */
+  std::optional<std::tuple<IborSingleCurve, std::vector<CreditCurve>>> load_curves(const ChronoDate& val_date,
+      const std::string& snapshot_file, const std::string& swap_file, const std::string& spreads_file, double recovery_rate) const;
+  void save_curves(const std::string& snapshot_file, const IborSingleCurve& libor_curve, const std::vector<CreditCurve>& ccurves) const;
   void plot_discount_curve(const IborSingleCurve& curve, const std::string& filename) const;
   void plot_zero_curve(const IborSingleCurve& curve, const std::string& filename) const;
   void plot_surv_prob_curves(const ChronoDate& val_date,const std::vector<CreditCurve>& ccurves, const std::string& filename) const;
@@ -24,16 +24,25 @@ int main() {
   ChronoDate val_date{2023,6,29};
 
   Application application{};
-  IborSingleCurve libor_curve = application.build_swap_curve(val_date,R"(../swap_curve.csv)",
-                                                             InterpTypes::FLAT_FWD_RATES);
+  IborSingleCurve libor_curve{};
+  std::vector<CreditCurve> credit_curves{};
+  // bootstrapped curves are cached next to the outputs and reused until the data files change
+  if (auto cached = application.load_curves(val_date, R"(curves.snap)", R"(../swap_curve.csv)",
+                                            R"(../current_spreads.csv)", RECOVERY_RATE)) {
+    std::tie(libor_curve, credit_curves) = std::move(*cached);
+  } else {
+    libor_curve = application.build_swap_curve(val_date,R"(../swap_curve.csv)",
+                                               InterpTypes::FLAT_FWD_RATES);
+    credit_curves = application.build_credit_curves(val_date,
+                                                    R"(../current_spreads.csv)",
+                                                    libor_curve, RECOVERY_RATE);
+    application.save_curves(R"(curves.snap)", libor_curve, credit_curves);
+  }
 
   if (python_home != NULL) {
     application.plot_discount_curve(libor_curve, R"(discount_curve)");
     application.plot_zero_curve(libor_curve, R"(zero_curve)");
   }
-  std::vector<CreditCurve> credit_curves = application.build_credit_curves(val_date,
-                                                                            R"(../current_spreads.csv)",
-                                                                            libor_curve, RECOVERY_RATE);
   if (python_home != NULL) {
     application.plot_surv_prob_curves(val_date, credit_curves, R"(surv_probs.png)");
     application.plot_hazard_curves(val_date, credit_curves, R"(hazard_rates.png)");
@@ -118,18 +127,19 @@ int main() {
   shocked_data.clear();
   spreads.clear();
   std::vector<double> rec_rates{ 0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0 };
-  std::vector<CreditCurve> bumped_curves{};
+  // the shocked curves do not depend on ntd, so each shock is rebuilt once rather than once per ntd
+  std::vector<std::vector<CreditCurve>> bumped_curves(rec_rates.size());
+  for (size_t i{0}; i < rec_rates.size(); ++i) {
+    for (const auto &c: credit_curves) {
+      bumped_curves[i].push_back(c.get_bumped_rec_rate_curve(rec_rates[i]));
+    }
+  }
 
   for (size_t ntd{1}; ntd < NUM_CREDITS +1; ++ntd) {
-    for (const auto &r: rec_rates) {
-      for (const auto &c: credit_curves) {
-        bumped_curves.push_back(c.get_bumped_rec_rate_curve(r));
-      }
-
-      auto [valuep, rpv01p, spdp] = basket.value_gaussian_mc(val_date, (int) ntd, bumped_curves, gauss_corr_matrix,
+    for (const auto &curves: bumped_curves) {
+      auto [valuep, rpv01p, spdp] = basket.value_gaussian_mc(val_date, (int) ntd, curves, gauss_corr_matrix,
                                                            libor_curve, 50000, seed, R"(PSEUDO)");
       spreads.push_back(std::round(spdp * 10000 * 1000.0) / 1000.0);
-      bumped_curves.clear();
     }
     shocked_data.push_back(spreads);
     spreads.clear();
@@ -140,19 +150,20 @@ int main() {
 
   shocked_data.clear();
   spreads.clear();
-  bumped_curves.clear();
   std::vector<double> spread_shocks{ -90, -80, -70, -60, -50, -40, -30, -20, -10, 0, 10, 20, 30, 40, 50, 60, 70, 80, 90 };
+  // relative shocks this large need the re-solved curves, CreditCurveOverlay only covers small bumps
+  bumped_curves.assign(spread_shocks.size(), {});
+  for (size_t i{0}; i < spread_shocks.size(); ++i) {
+    for (const auto &c: credit_curves) {
+      bumped_curves[i].push_back(c.get_bumped_spread_curve(spread_shocks[i]));
+    }
+  }
 
   for (size_t ntd{1}; ntd < NUM_CREDITS +1; ++ntd) {
-    for (const auto &s: spread_shocks) {
-      for (const auto &c: credit_curves) {
-        bumped_curves.push_back(c.get_bumped_spread_curve(s));
-      }
-
-      auto [valuep, rpv01p, spdp] = basket.value_gaussian_mc(val_date, (int) ntd, bumped_curves, gauss_corr_matrix,
+    for (const auto &curves: bumped_curves) {
+      auto [valuep, rpv01p, spdp] = basket.value_gaussian_mc(val_date, (int) ntd, curves, gauss_corr_matrix,
                                                              libor_curve, 50000, seed, R"(PSEUDO)");
       spreads.push_back(std::round(spdp * 10000 * 1000.0) / 1000.0);
-      bumped_curves.clear();
     }
     shocked_data.push_back(spreads);
     spreads.clear();
@@ -5,6 +5,7 @@
 #include <finproj/utils/Calendar.h>
 #include <finproj/utils/DayCount.h>
 #include <finproj/curves/CreditCurve.h>
+#include <finproj/curves/CurveOverlay.h>
 
 
 class CDS {
@@ -35,6 +36,15 @@ class CDS {
                            double recovery_rate,int num_of_steps = 25) const;
   double par_spread(const ChronoDate& valuation_date, const CreditCurve& credit_curve,double recovery_rate,
                     int num_of_steps = 25) const;
+  /** The same legs priced off a shifted view of a credit curve, for spread and hazard
+  rate risk without rebuilding the curve. Discounting uses the base curve's libor curve. */
+  std::tuple<double,double> value(const ChronoDate& valuation_date, const CreditCurveOverlay& credit_curve,
+                                   double recovery_rate, int num_of_steps = 25) const;
+  std::tuple<double,double> risky_pv01(const ChronoDate& valuation_date, const CreditCurveOverlay& credit_curve) const;
+  double protection_leg_pv(const ChronoDate& valuation_date, const CreditCurveOverlay& credit_curve,
+                           double recovery_rate,int num_of_steps = 25) const;
+  double par_spread(const ChronoDate& valuation_date, const CreditCurveOverlay& credit_curve,double recovery_rate,
+                    int num_of_steps = 25) const;
   double clean_price(const ChronoDate& valuation_date, const CreditCurve& credit_curve,double recovery_rate, int num_of_steps = 25) const;
   unsigned int accrued_days() const;
   double accrued_interest() const;
@@ -55,6 +65,15 @@ class CDS {
   DateGenRuleTypes date_gen_rule_type_{};
   std::vector<ChronoDate> adjusted_dates_{};
   std::vector<double> accrual_factors_{}, flows_{};
+
+  /** Leg kernels over any survival interpolator, only instantiated in CDS.cpp. */
+  template <class Credit>
+  std::tuple<double,double> risky_pv01_impl(const ChronoDate& valuation_date, const Credit& credit_interp,
+                                            const BasicInterpolator<FlatFwd>& rates_interp) const;
+  template <class Credit>
+  double protection_leg_pv_impl(const ChronoDate& valuation_date, const Credit& credit_interp,
+                                const BasicInterpolator<FlatFwd>& rates_interp, double recovery_rate,
+                                int num_of_steps) const;
 };
 
 #endif//FINPROJ_INCLUDE_FINPROJ_CURVES_CDS_H_
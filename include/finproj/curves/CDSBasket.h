@@ -23,7 +23,8 @@ class CDSBasket {
                                                        const IborSingleCurve& libor_curve,
                                                        int num_trials,
                                                        int seed,
-                                                       const std::string& random_number_generation) const;
+                                                       const std::string& random_number_generation,
+                                                       bool uniform_discounting = false) const;
   std::tuple<double,double,double> value_student_t_mc(const ChronoDate& valuation_date, int nth_to_default,
                                                        const std::vector<CreditCurve>& issuer_curves,
                                                        const MatrixXd& correlation_matrix,
@@ -31,11 +32,20 @@ class CDSBasket {
                                                        const IborSingleCurve& libor_curve,
                                                        int num_trials,
                                                        int seed,
-                                                        const std::string& random_number_generation) const;
+                                                        const std::string& random_number_generation,
+                                                       bool uniform_discounting = false) const;
+  /** Risky PV01 and protection leg value averaged over the trials of default_times.
+  With uniform_discounting the nth default times are discounted through a daily
+  libor_curve.uniform_lookup(), which saves a node search per trial but moves each df by
+  up to its max_error() relative; by default they are discounted by libor_curve.df(). */
   std::tuple<double,double> value_legs_mc(const ChronoDate& valuation_date, int nth_to_default,
                                            const MatrixXd& default_times,
                                            const std::vector<CreditCurve>& issuer_curves,
-                                           const IborSingleCurve& libor_curve) const;
+                                           const IborSingleCurve& libor_curve,
+                                           bool uniform_discounting = false) const;
+  /** Number of grid points of the daily lookup value_legs_mc discounts through over
+  [0, t_max]. */
+  static std::size_t daily_grid_points(double t_max);
 
  private:
   ChronoDate step_in_date_{};
@@ -0,0 +1,61 @@
+#ifndef FINPROJ_INCLUDE_FINPROJ_CURVES_CASHFLOWPLAN_H_
+#define FINPROJ_INCLUDE_FINPROJ_CURVES_CASHFLOWPLAN_H_
+#include <finproj/curves/DiscountCurve.h>
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+/** One payment of a plan, amount + weight * fwd paid at pay_time, where fwd is the
+simple rate projected over [start_time, end_time] with accrual factor alpha. Fixed
+payments have no weight and no projection. */
+struct PlannedCashflow {
+  double pay_time{}, amount{}, weight{}, start_time{}, end_time{}, alpha{};
+
+  /** Last time on the curve the payment looks at. */
+  [[nodiscard]] double horizon() const {
+    return weight == 0.0 ? pay_time : std::max({pay_time, start_time, end_time});
+  }
+};
+
+/** An instrument compiled for one valuation date into its unpaid cashflows, with the
+dates turned into times on the curve's time axis and the day count fractions, rates,
+notional and sign folded into the amounts, so that valuing it takes interpolations and
+arithmetic only. The value is that of the payments discounted to anchor_time, the
+valuation date or a deposit's start. A plan prices on any curve with the valuation date
+and day count type of the one it was compiled on. The cashflows are ordered by their
+horizons, so the ones a bootstrap node after some time cannot move come first. */
+class CashflowPlan {
+ public:
+  CashflowPlan() = default;
+  CashflowPlan(double anchor_time, std::vector<PlannedCashflow> cashflows);
+  /** Value discounting on disc_curve and projecting the forwards on index_curve. */
+  [[nodiscard]] double pv(const DiscountCurve& disc_curve, const DiscountCurve& index_curve) const;
+  [[nodiscard]] double pv(const DiscountCurve& curve) const;
+  /** pv() on a single curve and its derivative with respect to the discount factor of
+  the curve's last node. The cashflows before first are left out and head stands in for
+  them, as head_value() gives it. */
+  [[nodiscard]] std::pair<double, double> value_and_last_node_sensitivity(const DiscountCurve& curve,
+                                                                          std::size_t first = 0,
+                                                                          double head = 0.0) const;
+  /** pv() on a single curve with its gradient with respect to the discount factors of
+  all curve nodes written to grad; work is scratch of the same length. */
+  double value_and_node_sensitivities(const DiscountCurve& curve, std::span<double> grad,
+                                      std::span<double> work) const;
+  /** Index of the first cashflow with a horizon after t. */
+  [[nodiscard]] std::size_t first_after(double t) const;
+  /** Sum of the cashflows before first times their discount factors, not yet
+  discounted to the anchor. */
+  [[nodiscard]] double head_value(const DiscountCurve& curve, std::size_t first) const;
+  /** Multiplies all payments by factor, 1 / notional for values per unit notional. */
+  void scale(double factor);
+  [[nodiscard]] double anchor_time() const { return anchor_time_; }
+  [[nodiscard]] std::span<const PlannedCashflow> cashflows() const { return cashflows_; }
+
+ private:
+  double anchor_time_{};
+  std::vector<PlannedCashflow> cashflows_{};
+};
+
+#endif//FINPROJ_INCLUDE_FINPROJ_CURVES_CASHFLOWPLAN_H_
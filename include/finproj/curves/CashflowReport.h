@@ -0,0 +1,26 @@
+#ifndef FINPROJ_INCLUDE_FINPROJ_CURVES_CASHFLOWREPORT_H_
+#define FINPROJ_INCLUDE_FINPROJ_CURVES_CASHFLOWREPORT_H_
+#include <finproj/utils/ChronoDate.h>
+#include <cstddef>
+#include <vector>
+
+/** Breakdown of a swap leg valuation with one entry per payment of the schedule, as
+the legs' cashflow_report() fills it. Amounts and present values are as received,
+before the sign of a paying leg; the principal is in the last present value, and the
+payments on or before the valuation date have none. A report reused across
+valuations keeps its storage and stops allocating once it held the longest leg. */
+struct CashflowReport {
+  std::vector<ChronoDate> payment_dates{};
+  std::vector<double> rates{}, payments{}, payment_dfs{}, payment_pvs{}, cumulative_pvs{};
+
+  void resize(std::size_t num_payments){
+    payment_dates.resize(num_payments);
+    rates.resize(num_payments);
+    payments.resize(num_payments);
+    payment_dfs.resize(num_payments);
+    payment_pvs.resize(num_payments);
+    cumulative_pvs.resize(num_payments);
+  }
+};
+
+#endif//FINPROJ_INCLUDE_FINPROJ_CURVES_CASHFLOWREPORT_H_
@@ -5,23 +5,43 @@
 #include <finproj/utils/ChronoDate.h>
 #include <finproj/curves/IborSingleCurve.h>
 #include <finproj/utils/Interpolator.h>
+#include <finproj/utils/UniformLookup.h>
 
 class CDS; //forward declare CDS to avoid circular dependencies, cds.h is included in CreditCurve.cpp
+class CurveView;
 
 class CreditCurve{
  public:
   CreditCurve(const ChronoDate& valuation_date, const std::string& ticker, const std::vector<CDS>& cds_contracts,
         const IborSingleCurve& libor_curve,double recovery_rate,
         InterpTypes interp_type = InterpTypes::FLAT_FWD_RATES);
+  /** Curve restored from a snapshot view without bootstrapping. The contracts are only
+  kept for the bumped curves, which are rebuilt from them as usual. */
+  CreditCurve(const CurveView& view, const IborSingleCurve& libor_curve,
+              const std::vector<CDS>& cds_contracts = {});
   void build_curve();
+  /** Copy of the curve re-solved with every CDS coupon scaled by 1 + bump / 100. For small
+  shifts CreditCurveOverlay gives the risk without the copy or the solve. */
   CreditCurve get_bumped_spread_curve(double bump) const;
   CreditCurve get_bumped_rec_rate_curve(double bump) const;
   void validate() const;
   double get_rec_rate() const;
   void set_rec_rate(double rate);
+  [[nodiscard]] const ChronoDate& valuation_date() const { return valuation_date_; }
   double surv_prob(const ChronoDate& dt) const;
+  std::vector<double> surv_prob(const std::vector<ChronoDate>& dts) const;
+  /** Survival probabilities resampled on num_points uniform times over [0, t_max],
+  see UniformLookup for the error bound. */
+  UniformLookup uniform_lookup(double t_max, std::size_t num_points) const;
   std::vector<double> times_{}, values_{};
+  /** Flat forward interpolator over (times_, values_), kept in step with them by
+  build_curve. */
+  BasicInterpolator<FlatFwd> interpolator_{};
   IborSingleCurve libor_curve_{};
+  /** Flat forward interpolator over the nodes of libor_curve_, which the CDS legs
+  discount with. Fitted once with the curve, so the root search of build_curve does
+  not refit it on every valuation. */
+  BasicInterpolator<FlatFwd> libor_interpolator_{};
   double recovery_rate_{};
   std::string ticker_{};
  private:
@@ -0,0 +1,64 @@
+#ifndef FINPROJ_INCLUDE_FINPROJ_CURVES_CURVECUBE_H_
+#define FINPROJ_INCLUDE_FINPROJ_CURVES_CURVECUBE_H_
+#include <Eigen/Dense>
+#include <finproj/utils/ChronoDate.h>
+#include <finproj/utils/DayCount.h>
+#include <finproj/utils/Interpolator.h>
+#include <span>
+#include <vector>
+
+/** Many scenario discount curves on one node grid, for historical VaR and other
+scenario revaluation. Row s of the node matrix is scenario s and column j is node j;
+the matrix is column-major, so the scenarios of a node are contiguous and every query
+is a handful of column operations across all scenarios at once.
+
+Only the schemes that are linear in the node values are supported, FLAT_FWD_RATES
+(linear in -log(df)) and LINEAR_ZERO_RATES (linear in the zero rate). For them the
+interpolation weights at a time depend on the grid alone and are shared by all
+scenarios. Evaluation matches a DiscountCuveZeros built from each scenario's row,
+extrapolation included. */
+class CurveCube {
+ public:
+  /** zero_rates holds one scenario per row and one node per column, compounded at
+  freq_type. times are the node times and must be positive and increasing. The rates
+  are converted in place, so pass a temporary to avoid the copy. */
+  CurveCube(const std::vector<double>& times, Eigen::MatrixXd zero_rates,
+            FrequencyTypes freq_type = FrequencyTypes::ANNUAL,
+            InterpTypes interp_type = InterpTypes::FLAT_FWD_RATES);
+  CurveCube(const ChronoDate& valuation_date, const std::vector<ChronoDate>& zero_dates,
+            const Eigen::MatrixXd& zero_rates,
+            FrequencyTypes freq_type = FrequencyTypes::ANNUAL,
+            DayCountTypes day_count_type = DayCountTypes::ACT_ACT_ISDA,
+            InterpTypes interp_type = InterpTypes::FLAT_FWD_RATES);
+  [[nodiscard]] Eigen::Index num_scenarios() const { return values_.rows(); }
+  [[nodiscard]] Eigen::Index num_nodes() const { return values_.cols(); }
+  [[nodiscard]] const std::vector<double>& times() const { return times_; }
+  [[nodiscard]] InterpTypes interp_type() const { return interp_type_; }
+  /** Node discount factors, scenarios by nodes. */
+  [[nodiscard]] Eigen::MatrixXd dfs() const;
+  /** Discount factors of every scenario at every time, scenarios by times. out is
+  resized only when its shape differs. */
+  void df(std::span<const double> times, Eigen::MatrixXd& out) const;
+  [[nodiscard]] Eigen::MatrixXd df(std::span<const double> times) const;
+  [[nodiscard]] double df(Eigen::Index scenario, double time) const;
+  /** Present value in every scenario of amounts paid at times, the discount factor
+  matrix times the amount vector, accumulated one time at a time without forming the
+  matrix. */
+  [[nodiscard]] Eigen::VectorXd pv(std::span<const double> times, std::span<const double> amounts) const;
+
+ private:
+  /** The exponent -log(df(t)) is scale * (w0 * values_(:, k0) + w1 * values_(:, k1)). */
+  struct Weights {
+    Eigen::Index k0{}, k1{};
+    double w0{}, w1{}, scale{1.0};
+  };
+  [[nodiscard]] Weights weights(double t) const;
+
+  std::vector<double> times_{};
+  InterpTypes interp_type_{};
+  /** -log(df) per node for FLAT_FWD_RATES, the continuously compounded zero rate for
+  LINEAR_ZERO_RATES. */
+  Eigen::MatrixXd values_{};
+};
+
+#endif//FINPROJ_INCLUDE_FINPROJ_CURVES_CURVECUBE_H_
@@ -0,0 +1,90 @@
+#ifndef FINPROJ_INCLUDE_FINPROJ_CURVES_CURVEOVERLAY_H_
+#define FINPROJ_INCLUDE_FINPROJ_CURVES_CURVEOVERLAY_H_
+#include <finproj/curves/CreditCurve.h>
+#include <finproj/curves/DiscountCurve.h>
+#include <finproj/utils/ChronoDate.h>
+#include <finproj/utils/UniformLookup.h>
+#include <span>
+#include <vector>
+
+/** Time dependent shift s(t) of a continuously compounded zero rate, or of the average
+hazard rate -log(q(t)) / t of a survival curve. A shifted curve is base(t) * exp(-s(t) * t).
+The default shift is zero everywhere. */
+class ZeroShift {
+ public:
+  ZeroShift() = default;
+  static ZeroShift parallel(double bump);
+  /** Triangle of height bump at t_key, falling linearly to zero at t_left and t_right.
+  t_left == t_key keeps the shift flat before t_key and t_right == t_key keeps it flat
+  after, as for the first and last bucket of a key rate ladder. */
+  static ZeroShift key_rate(double t_left, double t_key, double t_right, double bump);
+  /** One key rate shift per pillar, each falling to zero at the neighbouring pillars.
+  The shifts add up to a parallel shift of bump. Pillars must be increasing. */
+  static std::vector<ZeroShift> key_rates(std::span<const double> pillars, double bump);
+  [[nodiscard]] double operator()(double t) const;
+  /** Multiplies values[i], taken at ts[i], by exp(-s(ts[i]) * ts[i]). */
+  void apply(std::span<const double> ts, std::span<double> values) const;
+
+ private:
+  ZeroShift(double t_left, double t_key, double t_right, double bump);
+
+  double t_left_{}, t_key_{}, t_right_{};
+  double bump_{};
+};
+
+/** Discount curve seen through a ZeroShift. It keeps a reference to the base curve and
+applies the shift on every query, so building one costs nothing and the base must
+outlive it. Changes to the base show through. */
+class DiscountCurveOverlay {
+ public:
+  DiscountCurveOverlay(const DiscountCurve& base, const ZeroShift& shift);
+  static DiscountCurveOverlay parallel(const DiscountCurve& base, double bump);
+  /** One overlay per key rate bucket, pillared on the curve nodes past time zero. */
+  static std::vector<DiscountCurveOverlay> key_rates(const DiscountCurve& base, double bump);
+  [[nodiscard]] const DiscountCurve& base() const { return *base_; }
+  [[nodiscard]] const ZeroShift& shift() const { return shift_; }
+  [[nodiscard]] double df(double time) const;
+  /** Dates are timed like the base curve, ACT_ACT_ISDA from its valuation date. */
+  [[nodiscard]] double df(const ChronoDate& date) const;
+  void df(std::span<const double> times, std::span<double> out) const;
+  void df(std::span<const ChronoDate> dates, std::span<double> out) const;
+  [[nodiscard]] UniformLookup uniform_lookup(double t_max, std::size_t num_points) const;
+  /** Interpolator interface, so that an overlay can stand in for a curve's interpolator
+  in templated pricing code and in UniformLookup::sample. */
+  [[nodiscard]] double interpolate(double t) const { return df(t); }
+  void interpolate(std::span<const double> ts, std::span<double> out) const { df(ts, out); }
+
+ private:
+  const DiscountCurve* base_;
+  ZeroShift shift_;
+};
+
+/** Credit curve seen through a ZeroShift of its hazard rates, referencing the base
+curve like DiscountCurveOverlay. Discounting stays on the base curve's libor curve. */
+class CreditCurveOverlay {
+ public:
+  CreditCurveOverlay(const CreditCurve& base, const ZeroShift& shift);
+  static CreditCurveOverlay parallel(const CreditCurve& base, double bump);
+  /** Parallel shift of the CDS spreads by an absolute bump, e.g. 0.0001 for one basis
+  point, mapped to a hazard rate shift of bump / (1 - recovery) by the credit triangle.
+  This is the first order effect of rebuilding the curve on spreads all raised by bump.
+  It differs from get_bumped_spread_curve, whose bump scales each spread by
+  (1 + bump / 100). */
+  static CreditCurveOverlay spread_shift(const CreditCurve& base, double bump);
+  /** One overlay per key rate bucket, pillared on the curve nodes past time zero. */
+  static std::vector<CreditCurveOverlay> key_rates(const CreditCurve& base, double bump);
+  [[nodiscard]] const CreditCurve& base() const { return *base_; }
+  [[nodiscard]] const ZeroShift& shift() const { return shift_; }
+  [[nodiscard]] double recovery_rate() const { return base_->recovery_rate_; }
+  [[nodiscard]] double surv_prob(const ChronoDate& dt) const;
+  [[nodiscard]] std::vector<double> surv_prob(const std::vector<ChronoDate>& dts) const;
+  [[nodiscard]] UniformLookup uniform_lookup(double t_max, std::size_t num_points) const;
+  [[nodiscard]] double interpolate(double t) const;
+  void interpolate(std::span<const double> ts, std::span<double> out) const;
+
+ private:
+  const CreditCurve* base_;
+  ZeroShift shift_;
+};
+
+#endif//FINPROJ_INCLUDE_FINPROJ_CURVES_CURVEOVERLAY_H_
@@ -0,0 +1,134 @@
+#ifndef FINPROJ_INCLUDE_FINPROJ_CURVES_CURVESNAPSHOT_H_
+#define FINPROJ_INCLUDE_FINPROJ_CURVES_CURVESNAPSHOT_H_
+#include <finproj/utils/Calendar.h>
+#include <finproj/utils/ChronoDate.h>
+#include <finproj/utils/DayCount.h>
+#include <finproj/utils/Interpolator.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class DiscountCurve;
+class CreditCurve;
+
+/** Binary snapshot of built curves, so that a run can price from curves bootstrapped
+by an earlier one.
+
+Layout, all integers and doubles little-endian, every array 8 byte aligned:
+  header (32 bytes): magic "FPCURVES", u32 format version, u32 number of curves,
+                     u64 directory offset, u64 file size
+  directory: one 64 byte record per curve
+    u32 kind, u32 InterpTypes, u32 valuation date as yyyymmdd, u32 number of nodes n,
+    f64 recovery rate, u64 offsets of the times (n), values (n) and fitted segments
+    (n + 1, five doubles each, see SegmentTable::Segment), u64 ticker offset,
+    u32 ticker length, u16 DayCountTypes, i16 FrequencyTypes
+Values are discount factors or survival probabilities depending on the kind. The day
+count and frequency are those of a discount curve, which its forwards and zero rates
+are quoted in, and zero for survival curves. The
+segments are written as fitted, so a view evaluates exactly like the curve it came
+from without refitting. */
+class CurveView {
+ public:
+  enum class Kind : std::uint32_t { DISCOUNT = 1, SURVIVAL = 2 };
+
+  [[nodiscard]] Kind kind() const { return kind_; }
+  [[nodiscard]] const ChronoDate& valuation_date() const { return valuation_date_; }
+  [[nodiscard]] InterpTypes interp_type() const { return interp_type_; }
+  [[nodiscard]] DayCountTypes day_count_type() const { return day_count_type_; }
+  [[nodiscard]] FrequencyTypes freq_type() const { return freq_type_; }
+  [[nodiscard]] double recovery_rate() const { return recovery_rate_; }
+  [[nodiscard]] std::string_view ticker() const { return ticker_; }
+  [[nodiscard]] std::span<const double> times() const { return times_; }
+  [[nodiscard]] std::span<const double> values() const { return values_; }
+  /** Discount factor or survival probability at time t. */
+  [[nodiscard]] double value(double t) const;
+  /** Same as value(t) for all of ts, written to out. */
+  void value(std::span<const double> ts, std::span<double> out) const;
+  /** Value at date, timed as the source curve does: ACT_ACT_ISDA for discount curves
+  and actual/365 days for survival curves. */
+  [[nodiscard]] double value(const ChronoDate& date) const;
+  /** The names of the curve classes, for code written against DiscountCurve or
+  CreditCurve. */
+  [[nodiscard]] double df(double t) const { return value(t); }
+  [[nodiscard]] double df(const ChronoDate& date) const { return value(date); }
+  [[nodiscard]] double surv_prob(const ChronoDate& date) const { return value(date); }
+
+ private:
+  friend class CurveSnapshot;
+  [[nodiscard]] double exponent(std::size_t segment, double t) const;
+
+  Kind kind_{Kind::DISCOUNT};
+  ChronoDate valuation_date_{};
+  InterpTypes interp_type_{InterpTypes::FLAT_FWD_RATES};
+  DayCountTypes day_count_type_{};
+  FrequencyTypes freq_type_{};
+  double recovery_rate_{};
+  std::string_view ticker_{};
+  std::span<const double> times_{};
+  std::span<const double> values_{};
+  std::span<const SegmentTable::Segment> segments_{};
+};
+
+/** A snapshot file mapped read-only into memory. The views point straight into the
+mapping, nothing is parsed or copied beyond the directory, and they stay valid for
+the lifetime of the snapshot. Only little-endian hosts can map a snapshot. */
+class CurveSnapshot {
+ public:
+  explicit CurveSnapshot(const std::string& path);
+  CurveSnapshot(const CurveSnapshot&) = delete;
+  CurveSnapshot& operator=(const CurveSnapshot&) = delete;
+  CurveSnapshot(CurveSnapshot&& other) noexcept;
+  CurveSnapshot& operator=(CurveSnapshot&& other) noexcept;
+  ~CurveSnapshot();
+
+  [[nodiscard]] std::size_t size() const { return views_.size(); }
+  [[nodiscard]] const CurveView& operator[](std::size_t i) const { return views_[i]; }
+  [[nodiscard]] const std::vector<CurveView>& curves() const { return views_; }
+  /** First curve of the given kind and ticker, nullptr when there is none. */
+  [[nodiscard]] const CurveView* find(CurveView::Kind kind, std::string_view ticker) const;
+  /** Views into a snapshot image already in memory, which must stay put while they are
+  used and start 8 byte aligned. Throws if the image is malformed. */
+  static std::vector<CurveView> parse(std::span<const std::byte> image);
+
+  static constexpr std::uint32_t format_version = 2;
+
+ private:
+  void unmap();
+
+  const std::byte* data_{};
+  std::size_t size_{};
+  std::vector<CurveView> views_{};
+};
+
+/** Collects built curves and writes them in the snapshot format. */
+class CurveSnapshotWriter {
+ public:
+  void add(const DiscountCurve& curve, std::string_view name);
+  void add(const CreditCurve& curve);
+  void write(const std::string& path) const;
+  /** The snapshot image write() puts in the file. */
+  [[nodiscard]] std::vector<char> bytes() const;
+
+ private:
+  struct Entry {
+    CurveView::Kind kind{};
+    InterpTypes interp_type{};
+    DayCountTypes day_count_type{};
+    FrequencyTypes freq_type{};
+    ChronoDate valuation_date{};
+    double recovery_rate{};
+    std::string ticker{};
+    std::vector<double> times{}, values{};
+    std::vector<SegmentTable::Segment> segments{};
+  };
+  void add(CurveView::Kind kind, const SegmentTable& table, DayCountTypes day_count_type,
+           FrequencyTypes freq_type, const ChronoDate& valuation_date, double recovery_rate,
+           std::string_view ticker);
+
+  std::vector<Entry> entries_{};
+};
+
+#endif//FINPROJ_INCLUDE_FINPROJ_CURVES_CURVESNAPSHOT_H_
@@ -0,0 +1,93 @@
+#ifndef FINPROJ_INCLUDE_FINPROJ_CURVES_CURVESTORE_H_
+#define FINPROJ_INCLUDE_FINPROJ_CURVES_CURVESTORE_H_
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+/** Publishes immutable versions of a curve to concurrent readers, RCU style.
+
+A reader takes a Snapshot, which pins one published version: the curve and its version
+number come from the same publication and stay valid for as long as the snapshot is
+held, however many versions are published meanwhile. Taking a snapshot is one atomic
+shared_ptr load and never waits for a writer. A writer builds the next curve off to
+the side, e.g. a fresh bootstrap, and publish() swaps it in; the old version is freed
+when its last reader lets go. Writers are serialized among themselves only, so
+versions increase in publication order.
+
+Curves with a freeze() member (DiscountCurve and its bootstraps) are frozen on
+publication, which makes their df cache safe to read from several threads. */
+template <class Curve>
+class CurveStore {
+  struct Entry {
+    std::uint64_t version{};
+    Curve curve;
+  };
+
+ public:
+  class Snapshot {
+   public:
+    Snapshot() = default;
+    [[nodiscard]] std::uint64_t version() const { return entry_ ? entry_->version : 0; }
+    [[nodiscard]] const Curve& curve() const { return entry_->curve; }
+    const Curve& operator*() const { return entry_->curve; }
+    const Curve* operator->() const { return &entry_->curve; }
+    explicit operator bool() const { return static_cast<bool>(entry_); }
+
+   private:
+    friend class CurveStore;
+    explicit Snapshot(std::shared_ptr<const Entry> entry):entry_{std::move(entry)}{}
+    std::shared_ptr<const Entry> entry_{};
+  };
+
+  CurveStore() = default;
+  explicit CurveStore(Curve curve) { publish(std::move(curve)); }
+  CurveStore(const CurveStore&) = delete;
+  CurveStore& operator=(const CurveStore&) = delete;
+
+  /** Current version, empty (version 0) before the first publication. */
+  [[nodiscard]] Snapshot snapshot() const { return Snapshot{current_.load(std::memory_order_acquire)}; }
+  [[nodiscard]] std::uint64_t version() const { return snapshot().version(); }
+  /** Makes curve the current version and returns its version number, starting at 1. */
+  std::uint64_t publish(Curve curve);
+  /** Publishes rebuild(current curve), serialized with other writers so that no update
+  is lost. rebuild receives a copy it may modify and return. */
+  template <class Rebuild>
+  std::uint64_t update(Rebuild&& rebuild);
+
+ private:
+  std::uint64_t publish_locked(Curve curve);
+
+  std::atomic<std::shared_ptr<const Entry>> current_{};
+  std::mutex writer_{};
+  std::uint64_t last_version_{};
+};
+
+template <class Curve>
+std::uint64_t CurveStore<Curve>::publish(Curve curve){
+  std::lock_guard lock{writer_};
+  return publish_locked(std::move(curve));
+}
+
+template <class Curve>
+template <class Rebuild>
+std::uint64_t CurveStore<Curve>::update(Rebuild&& rebuild){
+  std::lock_guard lock{writer_};
+  auto current = current_.load(std::memory_order_acquire);
+  if (!current)
+    throw std::runtime_error("No curve has been published to update");
+  return publish_locked(std::forward<Rebuild>(rebuild)(Curve{current->curve}));
+}
+
+template <class Curve>
+std::uint64_t CurveStore<Curve>::publish_locked(Curve curve){
+  if constexpr (requires(Curve& c) { c.freeze(); })
+    curve.freeze();
+  auto entry = std::make_shared<const Entry>(Entry{++last_version_, std::move(curve)});
+  current_.store(std::move(entry), std::memory_order_release);
+  return last_version_;
+}
+
+#endif//FINPROJ_INCLUDE_FINPROJ_CURVES_CURVESTORE_H_
@@ -3,10 +3,17 @@
 
 #include <finproj/utils/ChronoDate.h>
 #include <finproj/utils/Interpolator.h>
+#include <finproj/utils/UniformLookup.h>
 #include <finproj/utils/Calendar.h>
 #include <finproj/utils/DayCount.h>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+class CurveView;
+
 class DiscountCurve {
  public:
   DiscountCurve() = default;
@@ -18,23 +25,66 @@ class DiscountCurve {
                                FrequencyTypes freq_type = FrequencyTypes::ANNUAL,
                                DayCountTypes day_count_type = DayCountTypes::ACT_ACT_ISDA,
                                InterpTypes interp_type = InterpTypes::FLAT_FWD_RATES);
+  /** Rebuilds a curve from a snapshot view without bootstrapping; it refits to the
+  same segments and evaluates exactly like the view, in the stored day count and frequency. */
+  explicit DiscountCurve(const CurveView& view);
   std::vector<double> zero_to_df(const std::vector<double>& rates, const std::vector<double>& times,
                                 FrequencyTypes freq_type) const;
   std::vector<double> df_to_zero(const std::vector<double>& dfs,const std::vector<ChronoDate>& dates,
                                 FrequencyTypes freq_type, DayCountTypes day_count_type) const;
   std::vector<double> df_to_zero(const std::vector<double>& dfs,const std::vector<double>& times,
                                  FrequencyTypes freq_type) const;
-  std::vector<double> df(const std::vector<ChronoDate>& dates);
+  std::vector<double> df(const std::vector<ChronoDate>& dates) const;
+  /** Span versions of the date queries write into caller owned buffers of the same
+  length and allocate nothing. Dates are turned into ACT_ACT_ISDA year fractions from
+  the valuation date, the curve's own time axis; times() does that conversion once for
+  callers that query the same dates repeatedly through the time based overloads. */
+  void times(std::span<const ChronoDate> dates, std::span<double> out,
+             DayCountTypes day_count_type = DayCountTypes::ACT_ACT_ISDA) const;
+  void df(std::span<const ChronoDate> dates, std::span<double> out) const;
+  void df(std::span<const double> times, std::span<double> out) const;
   double df(const ChronoDate& date, DayCountTypes day_count_type = DayCountTypes::ACT_ACT_ISDA) const;
+  /** Memoizes df(date, day_count_type) per serial date and day count type. An entry
+  keeps its year fraction and the interpolator version it was computed for, so a refit
+  of the nodes only costs an interpolation on the next lookup and never returns a stale
+  value. Off by default; lookups write the cache and are not thread safe until freeze(). */
+  void enable_df_cache(bool enable = true);
+  /** Stops df(date, day_count_type) from writing the cache. The curve can then be read
+  from several threads; entries made stale by later node changes are recomputed on
+  every call instead of updated. */
+  void freeze();
+  [[nodiscard]] bool frozen() const { return frozen_; }
   double df(double time) const;
+  /** Resamples the curve on num_points uniform times over [0, t_max] for O(1) lookups,
+  see UniformLookup for the error bound. */
+  UniformLookup uniform_lookup(double t_max, std::size_t num_points) const;
   std::vector<double> zero_rates(const std::vector<ChronoDate>& dates, FrequencyTypes freq_type,
-                                DayCountTypes day_count_type);
-  std::vector<double> cc_rates(const std::vector<ChronoDate>& dates,DayCountTypes day_count_type = DayCountTypes::SIMPLE);
+                                DayCountTypes day_count_type) const;
+  void zero_rates(std::span<const ChronoDate> dates, std::span<double> out, FrequencyTypes freq_type,
+                  DayCountTypes day_count_type) const;
+  void zero_rates(std::span<const double> times, std::span<double> out, FrequencyTypes freq_type) const;
+  std::vector<double> cc_rates(const std::vector<ChronoDate>& dates,DayCountTypes day_count_type = DayCountTypes::SIMPLE) const;
+  void cc_rates(std::span<const ChronoDate> dates, std::span<double> out,
+                DayCountTypes day_count_type = DayCountTypes::SIMPLE) const;
+  /** Par swap rates for all maturities in one pass over the schedule of the longest;
+  the schedule is kept for the next call with the same effective date. */
   std::vector<double> swap_rates(const ChronoDate& effective_date, const std::vector<ChronoDate>& maturity_dates,
                                 FrequencyTypes freq_type = FrequencyTypes::ANNUAL,
                                 DayCountTypes day_count_type = DayCountTypes::THIRTY_E_360);
-  std::vector<double> fwd(const std::vector<ChronoDate>& dates);
-  std::vector<double> fwd(const std::vector<double>& times);
+  std::vector<double> fwd(const std::vector<ChronoDate>& dates) const;
+  std::vector<double> fwd(const std::vector<double>& times) const;
+  void fwd(std::span<const ChronoDate> dates, std::span<double> out) const;
+  void fwd(std::span<const double> times, std::span<double> out) const;
+  /** d df(time) / d dfs_[j] for every curve node j. */
+  std::vector<double> df_sensitivities(double time) const;
+  /** Same as df_sensitivities(time) at the time of date, written to out, which holds
+  one entry per node. */
+  void df_sensitivities(const ChronoDate& date, std::span<double> out) const;
+  /** Same as df_sensitivities(time), written to out. */
+  void df_sensitivities(double time, std::span<double> out) const;
+  /** df(time) together with d df(time) / d dfs_.back(), the derivative a bootstrap
+  needs for Newton steps on the node it is solving. */
+  [[nodiscard]] std::pair<double, double> df_and_last_node_sensitivity(double time) const;
   double fwd_rate(const ChronoDate& start_date, const ChronoDate& date, DayCountTypes day_count_type = DayCountTypes::ACT_360);
   double fwd_rate(const ChronoDate& start_date, std::string& tenor, DayCountTypes day_count_type = DayCountTypes::ACT_360);
 
@@ -50,6 +100,30 @@ class DiscountCurve {
   DayCountTypes day_count_type_{};
   Interpolator interpolator_{};
 
+ private:
+  struct CachedDf {
+    double t{}, df{};
+    std::uint64_t version{};
+  };
+  /** Payment schedule of swap_rates out to its longest maturity, with accrual factors
+  and curve times, reused while the effective date, the last maturity and the
+  conventions stay the same. */
+  struct SwapStrip {
+    int effective{}, last{}, valuation{};
+    FrequencyTypes freq_type{};
+    DayCountTypes day_count_type{};
+    std::vector<ChronoDate> dates{};
+    std::vector<double> alphas{}, times{}, dfs{};
+  };
+  [[nodiscard]] double year_frac(const ChronoDate& date, DayCountTypes day_count_type) const;
+  SwapStrip& swap_strip(const ChronoDate& effective_date, const ChronoDate& last_date,
+                        FrequencyTypes freq_type, DayCountTypes day_count_type);
+
+  mutable std::unordered_map<std::uint64_t, CachedDf> df_cache_{};
+  mutable int df_cache_valuation_{};
+  bool df_cache_enabled_{};
+  bool frozen_{};
+  SwapStrip swap_strip_{};
 
 };
 
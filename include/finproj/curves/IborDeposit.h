@@ -3,6 +3,7 @@
 
 #include <finproj/utils/ChronoDate.h>
 #include <finproj/utils/DayCount.h>
+#include <finproj/curves/CashflowPlan.h>
 #include <finproj/curves/DiscountCurve.h>
 #include <string>
 
@@ -25,13 +26,22 @@ class IborDeposit {
   IborDeposit(const IborDeposit& rhs) = default;
   double value(const ChronoDate& val_date, const DiscountCurve& libor_curve) const;
   double maturity_df() const;
+  /** The deposit compiled on curve's time axis: its repayment discounted to the start
+  date, as value() does. */
+  [[nodiscard]] CashflowPlan cashflow_plan(const ChronoDate& val_date, const DiscountCurve& curve) const;
+  /** d maturity_df() / d(deposit rate). */
+  [[nodiscard]] double maturity_df_rate_sensitivity() const;
+  /** d(value per unit notional) / d(deposit rate) on a single curve. */
+  [[nodiscard]] double quote_sensitivity(const ChronoDate& val_date, const DiscountCurve& curve) const;
 
   ChronoDate get_start_date() const;
   ChronoDate get_maturity_date() const;
   double get_notional() const;
+  double get_deposit_rate() const;
 
   void set_start_date(ChronoDate dt);
   void set_maturity_date(ChronoDate dt);
+  void set_deposit_rate(double rate);
 
 
  private:
@@ -2,6 +2,7 @@
 #define FINPROJ_INCLUDE_FINPROJ_CURVES_IBORFRA_H_
 #include <finproj/utils/ChronoDate.h>
 #include <finproj/utils/DayCount.h>
+#include <finproj/curves/CashflowPlan.h>
 #include <finproj/curves/DiscountCurve.h>
 #include <string>
 
@@ -25,9 +26,18 @@ class IborFRA {
           BusDayAdjustTypes bus_day_adjust_type = BusDayAdjustTypes::MODIFIED_FOLLOWING);
   double value(const ChronoDate& val_date, const DiscountCurve& disc_curve, const DiscountCurve& index_curve) const;
   double maturity_df(const DiscountCurve& index_curve) const;
+  /** The FRA compiled on curve's time axis for val_date, so that plan.pv(disc_curve,
+  index_curve) gives value(). */
+  [[nodiscard]] CashflowPlan cashflow_plan(const ChronoDate& val_date, const DiscountCurve& curve) const;
+  /** d maturity_df(index_curve) / d(FRA rate). */
+  [[nodiscard]] double maturity_df_rate_sensitivity(const DiscountCurve& index_curve) const;
+  /** d(value per unit notional) / d(FRA rate) on a single curve. */
+  [[nodiscard]] double quote_sensitivity(const ChronoDate& val_date, const DiscountCurve& curve) const;
   ChronoDate get_start_date() const;
   ChronoDate get_maturity_date() const;
   double get_notional() const;
+  double get_fra_rate() const;
+  void set_fra_rate(double rate);
 
  private:
 
@@ -4,24 +4,114 @@
 #include <finproj/curves/IborDeposit.h>
 #include <finproj/curves/IborFRA.h>
 #include <finproj/curves/IborSwap.h>
+#include <Eigen/Dense>
+#include <Eigen/SparseCore>
+#include <span>
+#include <utility>
 #include <vector>
 
+/** SEQUENTIAL solves one node per instrument in maturity order. GLOBAL then solves all
+nodes at once from that start, which reprices every instrument also when moving a node
+changes the curve in front of it, as the cubic schemes do. */
+enum class BootstrapTypes {
+  SEQUENTIAL = 1,
+  GLOBAL = 2
+};
+
 class IborSingleCurve : public DiscountCurve {
  public:
   IborSingleCurve() = default;
   IborSingleCurve ( const ChronoDate& val_date, const std::vector<IborDeposit>& ibor_deposits,
                   const std::vector<IborFRA>& ibor_fras, const std::vector<IborSwap>& ibor_swaps,
                   InterpTypes interp_type = InterpTypes::FLAT_FWD_RATES,
-                  bool check_refit = false);
+                  bool check_refit = false,
+                  BootstrapTypes bootstrap_type = BootstrapTypes::SEQUENTIAL);
+  /** Curve restored from a snapshot, see DiscountCurve(const CurveView&). It has no
+  instruments, so it cannot be rebuilt or refit checked. */
+  explicit IborSingleCurve(const CurveView& view);
   void validate_inputs();
   void build_curve();
+  /** Solves for one node per FRA and swap, valuing the instruments through their
+  cashflow plans. The flat forward and linear zero schemes
+  take Newton steps on the analytic derivative of the instrument value with respect to
+  the node, from the forward extrapolated off the previous node, and fall back to
+  bracketing only if Newton fails; the other schemes bracket. */
   void build_curve_using_1d_solver();
+  /** Newton iteration on all node discount factors together, each step solving the
+  sparse Jacobian of the instrument values with respect to the nodes. Starts from the
+  current nodes, normally the sequential solution, and throws if it does not converge. */
+  void build_curve_using_global_solver();
   void check_refits(double depo_tol, double fra_tol, double swap_tol);
+  /** Market quotes of the deposits, FRAs and swaps in that order: the deposit and FRA
+  rates and the swap coupons. The synthetic deposit the curve puts in front of forward
+  starting ones has no quote of its own; it takes the rate of the first deposit. */
+  [[nodiscard]] std::vector<double> quotes() const;
+  /** Rebuilds the curve on new_quotes, in the order of quotes(), keeping the
+  instruments. A sequential build keeps the nodes in front of the first changed quote,
+  which do not depend on it, and solves the others starting from their previous
+  values, so a tick in one quote costs a part of a full build. A global build runs its
+  Newton iteration from the previous solution. */
+  void update_quotes(std::span<const double> new_quotes);
+  /** Instrument revaluations the last build took in its root searches. */
+  [[nodiscard]] int solver_evaluations() const { return solver_evaluations_; }
+  /** Newton iterations of the last global solve. */
+  [[nodiscard]] int global_iterations() const { return global_iterations_; }
+  /** d(instrument value per unit notional) / d(node df) at the solution of the last
+  global solve. Rows are the deposits, FRAs and swaps in that order, columns the nodes
+  after the origin, which match them one to one. Empty after a sequential build. */
+  [[nodiscard]] const Eigen::SparseMatrix<double>& jacobian() const { return jacobian_; }
+  /** d(node df) / d(market quote) by the implicit function theorem on the instrument
+  equations, -J^-1 dV/dq, with J the Jacobian of the instrument values with respect to
+  the nodes. Rows are the nodes after the origin, columns the deposits, FRAs and swaps
+  in the order of quotes(), the column of the first deposit including the node moves of
+  the synthetic deposit in front of it. After a sequential build J is lower triangular,
+  each instrument taken on the nodes solved so far as the bootstrap saw it; after a
+  global build it is jacobian(). */
+  [[nodiscard]] Eigen::MatrixXd quote_jacobian() const;
+  /** Change in the value of portfolio for a one basis point rise in each market quote,
+  in the order of quotes(), without rebuilding the curve. It takes one
+  transposed solve of J on the portfolio's node sensitivities, valued on this curve as
+  both discount and index curve. */
+  [[nodiscard]] std::vector<double> bucketed_dv01(std::span<const IborSwap> portfolio) const;
  private:
+  /** Newton iteration on the last node from guess, value_and_derivative(df) returning
+  the instrument value and its derivative with the node set to df. Leaves the node at
+  the root and returns true, or returns false if the iteration failed to converge. */
+  template <class ValueAndDerivative>
+  bool solve_last_node_newton(ValueAndDerivative&& value_and_derivative, double guess);
+  void set_last_node(double df);
+  /** Solves the nodes of the instruments from first on, in the order of quotes(), on
+  top of the nodes in front of them, starting node first + k from seeds[k] if given. */
+  void solve_nodes_from(std::size_t first, std::span<const double> seeds);
+  /** Plan of instrument i of the deposits, FRAs and swaps per unit notional. */
+  [[nodiscard]] CashflowPlan instrument_plan(std::size_t i) const;
+  /** Value per unit notional of instrument i of the deposits, FRAs and swaps, less one
+  for deposits, with its node sensitivities in grad; work is scratch of its length. */
+  double instrument_residual(std::size_t i, const DiscountCurve& curve, std::span<double> grad,
+                             std::span<double> work) const;
+  /** d instrument_residual(i, curve) / d(quote of instrument i). */
+  [[nodiscard]] double instrument_quote_sensitivity(std::size_t i, const DiscountCurve& curve) const;
+  /** J, the Jacobian of the instrument values with respect to the nodes after the
+  origin, together with the derivatives of the instrument values by their quotes. */
+  [[nodiscard]] std::pair<Eigen::SparseMatrix<double>, Eigen::VectorXd> node_and_quote_jacobians() const;
+
   std::vector<IborDeposit> ibor_deposits_{};
   std::vector<IborFRA> ibor_fras_{};
   std::vector<IborSwap> ibor_swaps_{};
+  /** The instruments compiled per unit notional, which the solvers value, recompiled
+  for the quotes that change. */
+  std::vector<CashflowPlan> plans_{};
+  /** FRAs starting before the last deposit matures, whose node the sequential build
+  takes from maturity_df() on the curve in front of it rather than a root search. */
+  std::vector<bool> fras_from_start_df_{};
+  /** validate_inputs put a copy of the first deposit, starting on the valuation date,
+  in front of the deposits. */
+  bool synthetic_deposit_{};
   bool check_refit_{};
+  BootstrapTypes bootstrap_type_{BootstrapTypes::SEQUENTIAL};
+  int solver_evaluations_{};
+  int global_iterations_{};
+  Eigen::SparseMatrix<double> jacobian_{};
 };
 
 #endif//FINPROJ_INCLUDE_FINPROJ_CURVES_IBORSINGLECURVE_H_
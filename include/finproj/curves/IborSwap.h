@@ -4,6 +4,7 @@
 #include <finproj/utils/SwapTypes.h>
 #include <finproj/utils/Calendar.h>
 #include <finproj/utils/DayCount.h>
+#include <finproj/curves/CashflowPlan.h>
 #include <finproj/curves/DiscountCurve.h>
 #include <finproj/curves/SwapFixedLeg.h>
 #include <finproj/curves/SwapFloatLeg.h>
@@ -28,11 +29,28 @@ class IborSwap {
            CalendarTypes cal_type = CalendarTypes::WEEKEND,
            BusDayAdjustTypes bus_day_adjust_type = BusDayAdjustTypes::FOLLOWING,
            DateGenRuleTypes date_gen_rule_type = DateGenRuleTypes::BACKWARD);
+  /** pv() on disc_curve, with the float leg projected on index_curve if given. */
   double value(const ChronoDate& val_date, const DiscountCurve& disc_curve,std::optional<DiscountCurve> index_curve,
               std::optional<double> first_fixing_rate);
+  /** Value of the fixed and float legs, the float leg projected on index_curve, taking
+  the curves by reference and allocating nothing. */
+  [[nodiscard]] double pv(const ChronoDate& val_date, const DiscountCurve& disc_curve, const DiscountCurve& index_curve,
+                          std::optional<double> first_fixing_rate = std::nullopt) const;
+  /** pv() on a single curve. */
+  [[nodiscard]] double pv(const ChronoDate& val_date, const DiscountCurve& curve) const;
+  /** Both legs compiled on curve's time axis for val_date, so that plan.pv(disc_curve,
+  index_curve) gives pv() with the float leg accruing in curve's day count type. */
+  [[nodiscard]] CashflowPlan cashflow_plan(const ChronoDate& val_date, const DiscountCurve& curve,
+                                           std::optional<double> first_fixing_rate = std::nullopt) const;
+  /** d(value per unit notional) / d(fixed coupon) on a single curve. */
+  [[nodiscard]] double quote_sensitivity(const ChronoDate& val_date, const DiscountCurve& curve) const;
   double pv01(const ChronoDate& val_date,const DiscountCurve& disc_curve) ;
   double swap_rate(const ChronoDate& val_date, const DiscountCurve& disc_curve,std::optional<DiscountCurve>& index_curve,
               std::optional<double> first_fixing);
+  double get_notional() const;
+  double get_fixed_coupon() const;
+  /** Resets the fixed coupon, which the fixed leg's payments follow. */
+  void set_fixed_coupon(double coupon);
   SwapFixedLeg get_fixed_leg() const;
   SwapFloatLeg get_double_leg() const;
   ChronoDate get_eff_date() const;
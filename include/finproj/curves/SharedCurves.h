@@ -0,0 +1,112 @@
+#ifndef FINPROJ_INCLUDE_FINPROJ_CURVES_SHAREDCURVES_H_
+#define FINPROJ_INCLUDE_FINPROJ_CURVES_SHAREDCURVES_H_
+#include <finproj/curves/CurveSnapshot.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/** Curve sets published by one process to others through a POSIX shared memory object.
+
+The object holds a control block and two slots, each large enough for one curve
+snapshot image (see CurveSnapshot). The publisher writes the next image into the slot
+not holding the current generation and then bumps the generation counter, so readers
+of the current generation are never disturbed. A reader evaluates straight from the
+mapping and only has to retry when the publisher started to reuse its slot for a later
+generation while it was reading, which read() does for it. */
+namespace shared_curves {
+
+/** Layout of the control block at the start of the object. */
+struct Control {
+  char magic[8];
+  std::uint32_t format_version;
+  std::uint32_t reserved;
+  std::uint64_t capacity;
+  /** Last generation whose image is complete, and the one being written, in the
+  manner of a seqlock. */
+  std::atomic<std::uint64_t> generation;
+  std::atomic<std::uint64_t> writing;
+  std::atomic<std::uint64_t> length[2];
+};
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "The generation counter is shared between processes");
+
+constexpr std::size_t slot_offset = 64;
+constexpr std::uint32_t format_version = 1;
+
+}// namespace shared_curves
+
+class SharedCurvePublisher {
+ public:
+  /** Creates the shared memory object name ("/name") with room for images of up to
+  capacity bytes. An object left under that name is unlinked first; readers still
+  mapping it keep their curves but see no new generations. */
+  SharedCurvePublisher(const std::string& name, std::size_t capacity);
+  SharedCurvePublisher(const SharedCurvePublisher&) = delete;
+  SharedCurvePublisher& operator=(const SharedCurvePublisher&) = delete;
+  ~SharedCurvePublisher();
+  /** Publishes the curves collected in writer and returns their generation, from 1. */
+  std::uint64_t publish(const CurveSnapshotWriter& writer);
+  [[nodiscard]] std::uint64_t generation() const;
+  /** Removes the object name; processes that mapped it keep their mapping. */
+  static void unlink(const std::string& name);
+
+ private:
+  std::byte* data_{};
+  std::size_t size_{};
+  shared_curves::Control* control_{};
+};
+
+class SharedCurveReader {
+ public:
+  /** Maps the object published under name read-only. */
+  explicit SharedCurveReader(const std::string& name);
+  SharedCurveReader(const SharedCurveReader&) = delete;
+  SharedCurveReader& operator=(const SharedCurveReader&) = delete;
+  ~SharedCurveReader();
+  /** Latest published generation, 0 before the first publication. */
+  [[nodiscard]] std::uint64_t generation() const;
+  /** Calls fn(views, generation) with the views of the latest generation and returns
+  its result, calling it again on a newer generation if the slot was overwritten
+  during the call. fn must not keep the views. A reader caches the parsed views of
+  the last generation and belongs to one thread; threads share a mapping cheaply by
+  opening readers of their own. */
+  template <class Fn>
+  auto read(Fn&& fn);
+
+ private:
+  std::span<const CurveView> views(std::uint64_t generation);
+  [[nodiscard]] bool overwritten(std::uint64_t generation) const;
+
+  const std::byte* data_{};
+  std::size_t size_{};
+  const shared_curves::Control* control_{};
+  std::uint64_t cached_generation_{};
+  std::vector<CurveView> cached_views_{};
+};
+
+template <class Fn>
+auto SharedCurveReader::read(Fn&& fn){
+  for (;;) {
+    auto generation = this->generation();
+    if (generation == 0)
+      throw std::runtime_error("No curves have been published yet");
+    std::span<const CurveView> current{};
+    try {
+      current = views(generation);
+    } catch (const std::runtime_error&) {
+      // a slot overwritten while it was parsed fails validation, anything else is real
+      if (!overwritten(generation))
+        throw;
+      continue;
+    }
+    auto result = fn(current, generation);
+    if (!overwritten(generation))
+      return result;
+  }
+}
+
+#endif//FINPROJ_INCLUDE_FINPROJ_CURVES_SHAREDCURVES_H_
@@ -1,6 +1,8 @@
 #ifndef FINPROJ_INCLUDE_FINPROJ_CURVES_SWAPFIXEDLEG_H_
 #define FINPROJ_INCLUDE_FINPROJ_CURVES_SWAPFIXEDLEG_H_
 #include <finproj/utils/ChronoDate.h>
+#include <finproj/curves/CashflowPlan.h>
+#include <finproj/curves/CashflowReport.h>
 #include <string>
 #include <finproj/utils/Calendar.h>
 #include <finproj/utils/DayCount.h>
@@ -23,8 +25,21 @@ class SwapFixedLeg {
                DateGenRuleTypes date_gen_rule_type = DateGenRuleTypes::BACKWARD,
                bool end_of_month = false);
   std::vector<ChronoDate> generate_payment_dates() ;
-  double value(const ChronoDate& val_date, const DiscountCurve& disc_curve) ;
+  /** Same as pv(). */
+  double value(const ChronoDate& val_date, const DiscountCurve& disc_curve) const;
+  /** Value of the payments after val_date discounted to it. Allocates nothing. */
+  [[nodiscard]] double pv(const ChronoDate& val_date, const DiscountCurve& disc_curve) const;
+  /** pv() with the payments broken down into report, which is resized to the schedule. */
+  double cashflow_report(const ChronoDate& val_date, const DiscountCurve& disc_curve, CashflowReport& report) const;
+  /** Appends the payments after val_date, with their times on curve's time axis and
+  the leg's sign, for CashflowPlan. */
+  void append_cashflows(const ChronoDate& val_date, const DiscountCurve& curve,
+                        std::vector<PlannedCashflow>& cashflows) const;
+  /** Value of a unit coupon on the notional, the leg's sensitivity to its coupon. */
+  [[nodiscard]] double annuity(const ChronoDate& val_date, const DiscountCurve& disc_curve) const;
   double get_coupon() const;
+  /** Resets the coupon and with it the payment amounts of the schedule. */
+  void set_coupon(double coupon);
   double get_notional() const;
   std::vector<ChronoDate> get_payment_dates() const;
 
@@ -42,7 +57,7 @@ class SwapFixedLeg {
   DateGenRuleTypes date_gen_rule_type_{};
   bool end_of_month_{};
   std::vector<ChronoDate> payment_dates_{};
-  std::vector<double> payments_{}, payment_dfs_{}, payment_pvs_{}, cumulative_pvs_{};
+  std::vector<double> year_fracs_{}, payments_{};
 
 };
 
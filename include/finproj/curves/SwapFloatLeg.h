@@ -1,6 +1,8 @@
 #ifndef FINPROJ_INCLUDE_FINPROJ_CURVES_SWAPFLOATLEG_H_
 #define FINPROJ_INCLUDE_FINPROJ_CURVES_SWAPFLOATLEG_H_
 #include <finproj/utils/ChronoDate.h>
+#include <finproj/curves/CashflowPlan.h>
+#include <finproj/curves/CashflowReport.h>
 #include <string>
 #include <finproj/utils/Calendar.h>
 #include <finproj/utils/DayCount.h>
@@ -23,11 +25,30 @@ class SwapFloatLeg{
                DateGenRuleTypes date_gen_rule_type = DateGenRuleTypes::BACKWARD,
                bool end_of_month = false);
   std::vector<ChronoDate> generate_payment_dates() ;
+  /** Same as pv(). */
   double value(const ChronoDate& val_date, const DiscountCurve& disc_curve,
-              const DiscountCurve& index_curve,std::optional<double> first_fixing_rate) ;
+              const DiscountCurve& index_curve,std::optional<double> first_fixing_rate) const;
+  /** Value of the payments after val_date, projected on index_curve, the first of them
+  at first_fixing_rate if given, and discounted to val_date. Allocates nothing. */
+  [[nodiscard]] double pv(const ChronoDate& val_date, const DiscountCurve& disc_curve,
+                          const DiscountCurve& index_curve, std::optional<double> first_fixing_rate) const;
+  /** pv() with the payments broken down into report, which is resized to the schedule. */
+  double cashflow_report(const ChronoDate& val_date, const DiscountCurve& disc_curve,
+                         const DiscountCurve& index_curve, std::optional<double> first_fixing_rate,
+                         CashflowReport& report) const;
+  /** Appends the payments after val_date for CashflowPlan, as for SwapFixedLeg. Their
+  forwards accrue in the day count type of curve, the first of them fixed at
+  first_fixing_rate if given. */
+  void append_cashflows(const ChronoDate& val_date, const DiscountCurve& curve, std::optional<double> first_fixing_rate,
+                        std::vector<PlannedCashflow>& cashflows) const;
   DayCountTypes get_day_count_type() const;
 
  private:
+  /** Index of the first payment after val_date, the one a first fixing rate sets. */
+  [[nodiscard]] std::size_t first_paid_payment(const ChronoDate& val_date) const;
+  /** Forward rate over the accrual period of payment i projected on index_curve. */
+  [[nodiscard]] double forward_rate(std::size_t i, const DiscountCurve& index_curve) const;
+
   ChronoDate eff_date_{},termination_date_{}, maturity_date_{};
   SwapTypes leg_type_{};
   std::string tenor_{};
@@ -42,7 +63,7 @@ class SwapFloatLeg{
   bool end_of_month_{};
   std::vector<ChronoDate> payment_dates_{};
   std::vector<ChronoDate> start_accrual_dates_{},end_accrual_dates_{};
-  std::vector<double> year_fracs_{},rates_{},payments_{}, payment_dfs_{}, payment_pvs_{}, cumulative_pvs_{}, notionals_{};
+  std::vector<double> year_fracs_{}, notionals_{};
 };
 
 #endif//FINPROJ_INCLUDE_FINPROJ_CURVES_SWAPFLOATLEG_H_
@@ -0,0 +1,64 @@
+#ifndef FINPROJ_INCLUDE_FINPROJ_MODELS_PCASCENARIOGENERATOR_H_
+#define FINPROJ_INCLUDE_FINPROJ_MODELS_PCASCENARIOGENERATOR_H_
+#include <finproj/curves/CurveCube.h>
+#include <finproj/curves/DiscountCurve.h>
+#include <finproj/curves/IborSingleCurve.h>
+#include <Eigen/Dense>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/** Rate scenarios from the principal components of historical zero rate changes.
+
+The history is a series of continuously compounded zero rate curves on one grid of
+node times, oldest first. The covariance of the changes between consecutive curves is
+decomposed and the largest num_factors components are kept. A scenario is the base
+curve plus sum_k sqrt(horizon * lambda_k) * z_k * e_k with independent standard
+normals z_k, so horizon scales the one step changes to a longer holding period. The
+mean change is dropped.
+
+Scenarios are drawn in fixed blocks, each from its own engine seeded by the seed and
+the block index, so a run is reproducible for a given seed whatever the number of
+threads. */
+class PcaScenarioGenerator {
+ public:
+  /** zero_history holds one curve per row and one node per column; the node times
+  must be positive and increasing. */
+  PcaScenarioGenerator(const std::vector<double>& times, const Eigen::MatrixXd& zero_history,
+                       Eigen::Index num_factors);
+  /** Samples the zero rates of every curve at times first. */
+  PcaScenarioGenerator(const std::vector<double>& times, std::span<const IborSingleCurve> history,
+                       Eigen::Index num_factors);
+  [[nodiscard]] const std::vector<double>& times() const { return times_; }
+  /** Variances of the kept components, largest first. */
+  [[nodiscard]] const Eigen::VectorXd& eigenvalues() const { return eigenvalues_; }
+  /** Kept components, one unit column per factor, nodes by factors. */
+  [[nodiscard]] const Eigen::MatrixXd& components() const { return components_; }
+  /** Share of the total variance of the changes carried by the kept components. */
+  [[nodiscard]] double explained_variance() const;
+  /** num_scenarios shocked curves around base_zero_rates, continuously compounded on
+  times(). num_threads 0 uses the hardware concurrency. */
+  [[nodiscard]] CurveCube generate(const Eigen::VectorXd& base_zero_rates, Eigen::Index num_scenarios,
+                                   std::uint64_t seed, double horizon = 1.0,
+                                   InterpTypes interp_type = InterpTypes::FLAT_FWD_RATES,
+                                   unsigned num_threads = 0) const;
+  /** Same around the zero rates of base at times(). */
+  [[nodiscard]] CurveCube generate(const DiscountCurve& base, Eigen::Index num_scenarios, std::uint64_t seed,
+                                   double horizon = 1.0, InterpTypes interp_type = InterpTypes::FLAT_FWD_RATES,
+                                   unsigned num_threads = 0) const;
+  /** Continuously compounded zero rates of curve at times. */
+  static Eigen::VectorXd zero_rates(const DiscountCurve& curve, const std::vector<double>& times);
+
+  static constexpr Eigen::Index block_size = 4096;
+
+ private:
+  void fill_block(Eigen::Index block, std::uint64_t seed, const Eigen::MatrixXd& loadings,
+                  const Eigen::VectorXd& base_zero_rates, Eigen::MatrixXd& rates) const;
+
+  std::vector<double> times_{};
+  Eigen::VectorXd eigenvalues_{};
+  Eigen::MatrixXd components_{};
+  double total_variance_{};
+};
+
+#endif//FINPROJ_INCLUDE_FINPROJ_MODELS_PCASCENARIOGENERATOR_H_
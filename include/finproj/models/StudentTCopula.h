@@ -3,6 +3,7 @@
 #include <finproj/curves/CreditCurve.h>
 #include <finproj/utils/Misc.h>
 #include <Eigen/Dense>
+#include <span>
 using namespace Eigen;
 
 class StudentTCopula {
@@ -13,7 +14,7 @@ class StudentTCopula {
                             int num_trials,
                             int seed,
                          const std::string& random_number_generation) ;
-  static double uniform_to_default_time_student(double u, const std::vector<double>& times, const std::vector<double>& values);
+  static double uniform_to_default_time_student(double u, std::span<const double> times, std::span<const double> values);
 };
 
 #endif//FINPROJ_INCLUDE_FINPROJ_MODELS_STUDENTTCOPULA_H_
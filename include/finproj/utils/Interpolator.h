@@ -1,5 +1,12 @@
 #ifndef FINPROJ_INCLUDE_FINPROJ_UTILS_INTERPOLATOR_H_
 #define FINPROJ_INCLUDE_FINPROJ_UTILS_INTERPOLATOR_H_
+#include <finproj/utils/VecMath.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <variant>
 #include <vector>
 enum class InterpTypes {
   FLAT_FWD_RATES = 1,
@@ -12,20 +19,313 @@ enum class InterpTypes {
   PCHIP_LOG_DISCOUNT = 11
 };
 
+/** Fitted nodes and per segment coefficients shared by every interpolation scheme.
+The scheme only decides how the segments are built; evaluating them is left to the
+policies below. */
+class SegmentTable{
+ public:
+  /** Interpolant on one segment, y + b*(t - t0) + c*(t - t0)^2 + d*(t - t0)^3. This is
+  -log(df) for the forward rate and LOG_DISCOUNT schemes and the zero rate for the
+  ZERO_RATES schemes. Entry i covers (times_[i-1], times_[i]], entry 0 repeats entry 1
+  and the last entry extrapolates beyond the final node. */
+  struct Segment {
+    double t0{}, y{}, b{}, c{}, d{};
+  };
+  static constexpr double small = 1e-10;
+
+  SegmentTable() = default;
+  explicit SegmentTable(InterpTypes inter_type);
+  SegmentTable(const std::vector<double>& times, const std::vector<double>& dfs, InterpTypes inter_type);
+  void fit(const std::vector<double>& times, const std::vector<double>& dfs);
+  /** Moves the discount factor of the last node and refits. Cheaper than fit() since
+  the coefficients in front of the last node are reused. */
+  void set_last_value(double df);
+  /** Appends a node after the last one, refitting only the end of the curve. */
+  void push_node(double t, double df);
+  /** Removes the last node, refitting only the new end of the curve. */
+  void pop_node();
+  /** Reserves room for num_points nodes so that push_node does not reallocate. */
+  void reserve(std::size_t num_points);
+  [[nodiscard]] InterpTypes type() const { return inter_type_; }
+  /** Changes whenever the fitted curve does. Versions are drawn from one process wide
+  counter, so two tables share a version only if one is a copy of the other. */
+  [[nodiscard]] std::uint64_t version() const { return version_; }
+  [[nodiscard]] const Segment& segment(std::size_t i) const { return segments_[i]; }
+  [[nodiscard]] std::span<const Segment> segments() const { return segments_; }
+  [[nodiscard]] std::span<const double> times() const { return times_; }
+  [[nodiscard]] std::span<const double> dfs() const { return dfs_; }
+  /** Index of the segment holding t, i.e. of the first node with times_[i] >= t. */
+  [[nodiscard]] std::size_t find_segment(double t) const { return find_segment(times_, t); }
+  /** Same search over any increasing node times, for segments stored elsewhere. */
+  [[nodiscard]] static std::size_t find_segment(std::span<const double> times, double t);
+  /** Same as find_segment(t) but walks forward from hint when t lies beyond it, which
+  is a merge step for increasing t. */
+  [[nodiscard]] std::size_t find_segment(double t, std::size_t hint) const;
+  /** dE(t)/d(dfs_[j]) for every node j, where df(t) = exp(-E(t)). grad must hold one
+  entry per node. */
+  void exponent_gradient(double t, std::span<double> grad) const;
+  /** The last entry of exponent_gradient(t) alone, which is all a bootstrap moving its
+  last node needs. Constant time for the flat forward and linear zero schemes. */
+  [[nodiscard]] double last_exponent_gradient(double t) const;
+
+ private:
+  void build_segments();
+  void fit_segments(std::size_t first);
+  void fit_natural_spline(std::size_t first);
+  void fit_pchip(std::size_t first);
+  [[nodiscard]] double node_value(std::size_t i) const;
+  [[nodiscard]] double slope(std::size_t i) const;
+
+  std::vector<double> times_{};
+  std::vector<double> dfs_{};
+  std::vector<Segment> segments_{};
+  /** Node values in the form the scheme interpolates (see Segment), the node
+  derivatives of the cubic schemes (second derivatives for the natural splines, first
+  derivatives for PCHIP) and the forward sweep of the natural spline system. */
+  std::vector<double> values_{};
+  std::vector<double> derivs_{};
+  std::vector<double> sweep_c_{};
+  std::vector<double> sweep_d_{};
+  InterpTypes inter_type_{InterpTypes::FLAT_FWD_RATES};
+  bool zero_rates_{};
+  int num_points_{};
+  std::uint64_t version_{};
+};
+
+inline std::size_t SegmentTable::find_segment(std::span<const double> times, double t){
+  // branch-free lower bound: index of the first node with times[i] >= t
+  const double* base = times.data();
+  auto len = times.size();
+  while (len > 1) {
+    auto half = len / 2;
+    base = (base[half - 1] < t) ? base + half : base;
+    len -= half;
+  }
+  return static_cast<std::size_t>(base - times.data()) + (*base < t ? 1 : 0);
+}
+
+inline std::size_t SegmentTable::find_segment(double t, std::size_t hint) const{
+  auto n = times_.size();
+  if (hint == 0 || hint > n || !(times_[hint - 1] < t))
+    return find_segment(t);
+  // merge step: walk forward over the nodes passed since the hinted segment
+  while (hint < n && times_[hint] < t)
+    ++hint;
+  return hint;
+}
+
+/** Interpolation policies. Each one evaluates -log(df) on a segment with only the
+polynomial degree its schemes need, its time derivative (the instantaneous forward),
+and lists the InterpTypes whose segments it can evaluate. */
+struct FlatFwd {
+  static constexpr InterpTypes default_type = InterpTypes::FLAT_FWD_RATES;
+  static constexpr bool accepts(InterpTypes type) { return type == InterpTypes::FLAT_FWD_RATES; }
+  static double exponent(const SegmentTable::Segment& seg, double t) {
+    return seg.y + (t - seg.t0) * seg.b;
+  }
+  static double forward(const SegmentTable::Segment& seg, double) { return seg.b; }
+};
+
+struct LinearZero {
+  static constexpr InterpTypes default_type = InterpTypes::LINEAR_ZERO_RATES;
+  static constexpr bool accepts(InterpTypes type) { return type == InterpTypes::LINEAR_ZERO_RATES; }
+  static double exponent(const SegmentTable::Segment& seg, double t) {
+    return (seg.y + (t - seg.t0) * seg.b) * t;
+  }
+  static double forward(const SegmentTable::Segment& seg, double t) {
+    return seg.y + (t - seg.t0) * seg.b + t * seg.b;
+  }
+};
+
+struct LinearFwd {
+  static constexpr InterpTypes default_type = InterpTypes::LINEAR_FWD_RATES;
+  static constexpr bool accepts(InterpTypes type) { return type == InterpTypes::LINEAR_FWD_RATES; }
+  static double exponent(const SegmentTable::Segment& seg, double t) {
+    auto dt = t - seg.t0;
+    return seg.y + dt * (seg.b + dt * seg.c);
+  }
+  static double forward(const SegmentTable::Segment& seg, double t) {
+    return seg.b + 2.0 * (t - seg.t0) * seg.c;
+  }
+};
+
+struct CubicLog {
+  static constexpr InterpTypes default_type = InterpTypes::NATCUBIC_LOG_DISCOUNT;
+  static constexpr bool accepts(InterpTypes type) {
+    return type == InterpTypes::NATCUBIC_LOG_DISCOUNT || type == InterpTypes::PCHIP_LOG_DISCOUNT;
+  }
+  static double exponent(const SegmentTable::Segment& seg, double t) {
+    auto dt = t - seg.t0;
+    return seg.y + dt * (seg.b + dt * (seg.c + dt * seg.d));
+  }
+  static double forward(const SegmentTable::Segment& seg, double t) {
+    auto dt = t - seg.t0;
+    return seg.b + dt * (2.0 * seg.c + 3.0 * dt * seg.d);
+  }
+};
+
+struct CubicZero {
+  static constexpr InterpTypes default_type = InterpTypes::FINCUBIC_ZERO_RATES;
+  static constexpr bool accepts(InterpTypes type) {
+    return type == InterpTypes::FINCUBIC_ZERO_RATES || type == InterpTypes::NATCUBIC_ZERO_RATES ||
+           type == InterpTypes::PCHIP_ZERO_RATES;
+  }
+  static double exponent(const SegmentTable::Segment& seg, double t) {
+    auto dt = t - seg.t0;
+    return (seg.y + dt * (seg.b + dt * (seg.c + dt * seg.d))) * t;
+  }
+  static double forward(const SegmentTable::Segment& seg, double t) {
+    auto dt = t - seg.t0;
+    return seg.y + dt * (seg.b + dt * (seg.c + dt * seg.d)) + t * (seg.b + dt * (2.0 * seg.c + 3.0 * dt * seg.d));
+  }
+};
+
+/** Interpolator with the scheme fixed at compile time, so the evaluation in a hot
+loop is a segment lookup, the policy's polynomial and an exp, all inlined. */
+template <class Policy>
+class BasicInterpolator{
+ public:
+  BasicInterpolator() = default;
+  explicit BasicInterpolator(InterpTypes inter_type);
+  BasicInterpolator(const std::vector<double>& times, const std::vector<double>& dfs,
+                    InterpTypes inter_type = Policy::default_type);
+  void fit(const std::vector<double>& times, const std::vector<double>& dfs) { table_.fit(times, dfs); }
+  void set_last_value(double df) { table_.set_last_value(df); }
+  void push_node(double t, double df) { table_.push_node(t, df); }
+  void pop_node() { table_.pop_node(); }
+  void reserve(std::size_t num_points) { table_.reserve(num_points); }
+  [[nodiscard]] InterpTypes type() const { return table_.type(); }
+  [[nodiscard]] std::uint64_t version() const { return table_.version(); }
+  [[nodiscard]] const SegmentTable& table() const { return table_; }
+  [[nodiscard]] double interpolate(double t) const;
+  /** Same as interpolate(t) but starts the segment search from hint, which is updated
+  to the segment found. Passing the same hint for increasing t avoids the search. */
+  [[nodiscard]] double interpolate(double t, std::size_t& hint) const;
+  /** Discount factors for all of ts, written to out. Increasing ts are matched to
+  segments in a single merge pass and the exponentials are taken in one batch. ts and
+  out may be the same span. */
+  void interpolate(std::span<const double> ts, std::span<double> out) const;
+  /** Instantaneous forward rate -d log(df)/dt at t. */
+  [[nodiscard]] double forward(double t) const;
+  void forward(std::span<const double> ts, std::span<double> out) const;
+  /** d(df)/dt at t. */
+  [[nodiscard]] double derivative(double t) const;
+  /** d(df(t))/d(df_j) for every node j, written to out. */
+  void node_sensitivities(double t, std::span<double> out) const;
+
+ private:
+  static SegmentTable checked_table(InterpTypes inter_type) {
+    if (!Policy::accepts(inter_type))
+      throw std::runtime_error("Interpolation type not supported by this policy");
+    return SegmentTable{inter_type};
+  }
+
+  SegmentTable table_{Policy::default_type};
+};
+
+template <class Policy>
+BasicInterpolator<Policy>::BasicInterpolator(InterpTypes inter_type):table_{checked_table(inter_type)}{}
+
+template <class Policy>
+BasicInterpolator<Policy>::BasicInterpolator(const std::vector<double>& times, const std::vector<double>& dfs,
+                                             InterpTypes inter_type):table_{checked_table(inter_type)}{
+  table_.fit(times, dfs);
+}
+
+template <class Policy>
+double BasicInterpolator<Policy>::interpolate(double t) const{
+  if (t < SegmentTable::small)
+    return 1.0;
+  return std::exp(-Policy::exponent(table_.segment(table_.find_segment(t)), t));
+}
+
+template <class Policy>
+double BasicInterpolator<Policy>::interpolate(double t, std::size_t& hint) const{
+  if (t < SegmentTable::small)
+    return 1.0;
+  hint = table_.find_segment(t, hint);
+  return std::exp(-Policy::exponent(table_.segment(hint), t));
+}
+
+template <class Policy>
+void BasicInterpolator<Policy>::interpolate(std::span<const double> ts, std::span<double> out) const{
+  if (ts.size() != out.size())
+    throw std::runtime_error("Times and output have different lengths");
+  std::size_t hint{0};
+  for (std::size_t k{0}; k < ts.size(); ++k) {
+    auto t = ts[k];
+    if (t < SegmentTable::small) {
+      out[k] = 0.0;
+      continue;
+    }
+    hint = table_.find_segment(t, hint);
+    out[k] = Policy::exponent(table_.segment(hint), t);
+  }
+  vecmath::exp_neg(out);
+}
+
+template <class Policy>
+double BasicInterpolator<Policy>::forward(double t) const{
+  return Policy::forward(table_.segment(table_.find_segment(t)), t);
+}
+
+template <class Policy>
+void BasicInterpolator<Policy>::forward(std::span<const double> ts, std::span<double> out) const{
+  if (ts.size() != out.size())
+    throw std::runtime_error("Times and output have different lengths");
+  std::size_t hint{0};
+  for (std::size_t k{0}; k < ts.size(); ++k) {
+    hint = table_.find_segment(ts[k], hint);
+    out[k] = Policy::forward(table_.segment(hint), ts[k]);
+  }
+}
+
+template <class Policy>
+double BasicInterpolator<Policy>::derivative(double t) const{
+  return -forward(t) * interpolate(t);
+}
+
+template <class Policy>
+void BasicInterpolator<Policy>::node_sensitivities(double t, std::span<double> out) const{
+  table_.exponent_gradient(t, out);
+  auto df = interpolate(t);
+  for (auto& g : out)
+    g = t < SegmentTable::small ? 0.0 : -df * g;
+}
+
+/** Interpolator with the scheme chosen at runtime. Holds one BasicInterpolator per
+policy in a variant and forwards every call to it; code with a known scheme in a
+hot loop should use BasicInterpolator directly. */
 class Interpolator{
  public:
   Interpolator(const std::vector<double>& times, const std::vector<double>& dfs, InterpTypes inter_type);
   Interpolator();
   explicit Interpolator(InterpTypes inter_type);
   void fit(const std::vector<double>& times, const std::vector<double>& dfs);
+  /** Moves the discount factor of the last node and refits. Cheaper than fit() since
+  the coefficients in front of the last node are reused. */
+  void set_last_value(double df);
+  void push_node(double t, double df);
+  void pop_node();
+  void reserve(std::size_t num_points);
+  /** See SegmentTable::version. */
+  [[nodiscard]] std::uint64_t version() const;
+  [[nodiscard]] const SegmentTable& table() const;
   [[nodiscard]] double interpolate(double t) const ;
+  [[nodiscard]] double interpolate(double t, std::size_t& hint) const ;
+  void interpolate(std::span<const double> ts, std::span<double> out) const ;
+  [[nodiscard]] double forward(double t) const ;
+  void forward(std::span<const double> ts, std::span<double> out) const ;
+  [[nodiscard]] double derivative(double t) const ;
+  void node_sensitivities(double t, std::span<double> out) const ;
 
  private:
-  std::vector<double> times_{};
-  std::vector<double> dfs_{};
-  InterpTypes inter_type_;
-  int num_points_{};
-  double small = 1e-10;
+  using Variant = std::variant<BasicInterpolator<FlatFwd>, BasicInterpolator<LinearZero>,
+                               BasicInterpolator<LinearFwd>, BasicInterpolator<CubicLog>,
+                               BasicInterpolator<CubicZero>>;
+  static Variant make(InterpTypes inter_type);
+
+  Variant impl_{};
 };
 
 #endif//FINPROJ_INCLUDE_FINPROJ_UTILS_INTERPOLATOR_H_
@@ -1,8 +1,10 @@
 #ifndef FINPROJ_INCLUDE_FINPROJ_UTILS_MISC_H_
 #define FINPROJ_INCLUDE_FINPROJ_UTILS_MISC_H_
 
+#include <algorithm>
 #include <vector>
 #include <cmath>
+#include <span>
 #include <fstream>
 #include <Eigen/Dense>
 #include <boost/random/sobol.hpp>
@@ -123,18 +125,19 @@ inline double N(double x) {
   return phi;
 }
 
-inline double uniform_to_default_time(double u, const std::vector<double>& times, const std::vector<double>& values) {
+inline double uniform_to_default_time(double u, std::span<const double> times, std::span<const double> values) {
   if (u == 0.0)
     return 99999.0;
   if (u == 1.0)
     return 0.0;
   size_t num_points = times.size();
+  /** Survival probabilities do not increase, so the first node with values[i] < u is
+  found by bisection. That node also has values[i - 1] >= u, the bracket we want. */
   size_t index = 0;
-  for (size_t i{1};i<num_points;++i){
-    if (u <= values[i - 1] && u > values[i]){
-      index = i;
-      break;
-    }
+  if (num_points > 1 && u <= values[0]) {
+    auto it = std::partition_point(values.begin() + 1, values.end(), [u](double q) { return q >= u; });
+    if (it != values.end())
+      index = static_cast<size_t>(it - values.begin());
   }
   double tau = 0.0;
   if (index == num_points + 1) {
@@ -0,0 +1,80 @@
+#ifndef FINPROJ_INCLUDE_FINPROJ_UTILS_UNIFORMLOOKUP_H_
+#define FINPROJ_INCLUDE_FINPROJ_UTILS_UNIFORMLOOKUP_H_
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/** Discount factor (or survival probability) curve resampled on a uniform time grid
+t_k = k * t_max / (n - 1). -log(df) is stored per grid cell and interpolated linearly,
+so a lookup is one multiply, one truncation and one exp with no search.
+
+Error: on a cell of width h the chord of y = -log(df) deviates from the exact y by at
+most h^2/8 * max|f'| where the forward f = y' is smooth, and by at most h/4 * |jump in
+f| in a cell holding a node of a flat forward curve. The relative df error equals the
+error in y to first order. max_error() reports the largest relative df error measured
+at build time over the cell midpoints and the curve nodes, which is exact for flat
+forward curves. Times past t_max continue the last cell. */
+class UniformLookup{
+ public:
+  UniformLookup() = default;
+  UniformLookup(double t_max, const std::vector<double>& dfs);
+  /** Samples interp on num_points grid times over [0, t_max] and measures max_error()
+  against it at the cell midpoints and at the given curve nodes. */
+  template <class Interp>
+  static UniformLookup sample(const Interp& interp, double t_max, std::size_t num_points,
+                              std::span<const double> nodes);
+  [[nodiscard]] double interpolate(double t) const;
+  [[nodiscard]] double max_error() const { return max_error_; }
+  [[nodiscard]] double t_max() const { return t_max_; }
+
+ private:
+  struct Cell {
+    double y{}, dy{};
+  };
+  void measure_error(std::span<const double> ts, std::span<const double> exact);
+
+  std::vector<Cell> cells_{};
+  double t_max_{};
+  double inv_step_{};
+  double max_error_{};
+};
+
+inline double UniformLookup::interpolate(double t) const{
+  if (t < 1e-10)
+    return 1.0;
+  auto x = t * inv_step_;
+  auto i = std::min(static_cast<std::size_t>(x), cells_.size() - 1);
+  const auto& cell = cells_[i];
+  return std::exp(-(cell.y + (x - static_cast<double>(i)) * cell.dy));
+}
+
+template <class Interp>
+UniformLookup UniformLookup::sample(const Interp& interp, double t_max, std::size_t num_points,
+                                    std::span<const double> nodes){
+  num_points = std::max<std::size_t>(num_points, 2);
+  auto step = t_max / static_cast<double>(num_points - 1);
+  std::vector<double> ts(num_points), dfs(num_points);
+  for (std::size_t k{0}; k < num_points; ++k)
+    ts[k] = static_cast<double>(k) * step;
+  // right limit at zero, the curves return exactly 1 below 1e-10
+  ts[0] = 1e-10;
+  interp.interpolate(ts, dfs);
+  UniformLookup lookup{t_max, dfs};
+
+  std::vector<double> check{};
+  check.reserve(num_points + nodes.size());
+  for (std::size_t k{1}; k < num_points; ++k)
+    check.push_back((static_cast<double>(k) - 0.5) * step);
+  for (auto t : nodes)
+    if (t > 0.0 && t < t_max)
+      check.push_back(t);
+  std::sort(check.begin(), check.end());
+  std::vector<double> exact(check.size());
+  interp.interpolate(check, exact);
+  lookup.measure_error(check, exact);
+  return lookup;
+}
+
+#endif//FINPROJ_INCLUDE_FINPROJ_UTILS_UNIFORMLOOKUP_H_
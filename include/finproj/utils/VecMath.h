@@ -0,0 +1,29 @@
+#ifndef FINPROJ_INCLUDE_FINPROJ_UTILS_VECMATH_H_
+#define FINPROJ_INCLUDE_FINPROJ_UTILS_VECMATH_H_
+#include <span>
+
+/** Batched elementary functions for the pricing loops. Each call fills y[i] = f(x[i])
+over the whole span; x and y may be the same span. On x86_64 the kernels run in
+AVX-512 or AVX2 lanes, chosen once at runtime from the CPU, and elsewhere fall back to
+the <cmath> functions. Results are within a few ulp of <cmath>; lanes outside the
+kernels' range (overflow, underflow, non-positive log arguments, NaN) are handed to
+<cmath> so special values match it exactly. */
+namespace vecmath {
+
+enum class Isa { SCALAR, AVX2, AVX512 };
+
+/** Instruction set the kernels dispatch to on this machine. */
+Isa active_isa();
+
+void exp(std::span<const double> x, std::span<double> y);
+void log(std::span<const double> x, std::span<double> y);
+void expm1(std::span<const double> x, std::span<double> y);
+void exp(std::span<const float> x, std::span<float> y);
+void log(std::span<const float> x, std::span<float> y);
+void expm1(std::span<const float> x, std::span<float> y);
+/** x[i] = exp(-x[i]) in place, the discount factor of an exponent. */
+void exp_neg(std::span<double> x);
+
+}// namespace vecmath
+
+#endif//FINPROJ_INCLUDE_FINPROJ_UTILS_VECMATH_H_
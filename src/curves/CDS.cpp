@@ -1,4 +1,5 @@
 #include <finproj/curves/CDS.h>
+#include <finproj/utils/VecMath.h>
 #include <tuple>
 #include <cmath>
 
@@ -99,6 +100,16 @@ void CDS::calc_flows() {
 }
 
 std::tuple<double,double> CDS::risky_pv01(const ChronoDate& valuation_date, const CreditCurve& credit_curve) const{
+  return risky_pv01_impl(valuation_date, credit_curve.interpolator_, credit_curve.libor_interpolator_);
+}
+
+std::tuple<double,double> CDS::risky_pv01(const ChronoDate& valuation_date, const CreditCurveOverlay& credit_curve) const{
+  return risky_pv01_impl(valuation_date, credit_curve, credit_curve.base().libor_interpolator_);
+}
+
+template <class Credit>
+std::tuple<double,double> CDS::risky_pv01_impl(const ChronoDate& valuation_date, const Credit& credit_interp,
+                                               const BasicInterpolator<FlatFwd>& rates_interp) const{
   std::vector<double> payment_times{};
   for (size_t i{0};i < adjusted_dates_.size(); ++i){
     auto t = (adjusted_dates_[i] - valuation_date)/365.0;
@@ -112,26 +123,35 @@ std::tuple<double,double> CDS::risky_pv01(const ChronoDate& valuation_date, cons
   auto teff = (eff - valuation_date) / 365.0;
 
   auto couponAccruedIndicator = 1;
-  auto tncd = payment_times[1];
-  auto credit_interp = Interpolator(credit_curve.times_,credit_curve.values_,InterpTypes::FLAT_FWD_RATES);
-  auto rates_interp = Interpolator(credit_curve.libor_curve_.times_,credit_curve.libor_curve_.dfs_,InterpTypes::FLAT_FWD_RATES);
   auto qeff = credit_interp.interpolate(teff);
-  auto q1 = credit_interp.interpolate(tncd);
-  auto z1 = rates_interp.interpolate(tncd);
+  auto num_times = payment_times.size();
+  std::vector<double> qs(num_times), zs(num_times), log_q(num_times), log_z(num_times);
+  credit_interp.interpolate(std::span(payment_times).subspan(1), std::span(qs).subspan(1));
+  rates_interp.interpolate(std::span(payment_times).subspan(1), std::span(zs).subspan(1));
+  auto q1 = qs[1];
+  auto z1 = zs[1];
+  /** log(q2/q1) and log(z2/z1) of every period in two batched calls */
+  for (size_t i{2}; i < num_times; ++i){
+    log_q[i] = qs[i] / qs[i - 1];
+    log_z[i] = zs[i] / z1;
+  }
+  vecmath::log(std::span(log_q).subspan(2), std::span(log_q).subspan(2));
+  vecmath::log(std::span(log_z).subspan(2), std::span(log_z).subspan(2));
   auto full_rpv01 = q1 * z1 * year_fracs[1];
   full_rpv01 = full_rpv01 + z1 * (qeff - q1) * accrual_factorPCDToNow * couponAccruedIndicator;
   full_rpv01 += 0.5 * z1 * (qeff - q1) * (year_fracs[1] - accrual_factorPCDToNow) * couponAccruedIndicator;
   for (size_t i{2}; i<payment_times.size();++i){
-    auto t2 = payment_times[i];
-    auto q2 = credit_interp.interpolate(t2);
-    auto z2 = rates_interp.interpolate(t2);
+    auto q2 = qs[i];
+    auto z2 = zs[i];
     auto accrual_factor = year_fracs[i];
     full_rpv01 += q2 * z2 * accrual_factor;
     auto tau = accrual_factor;
-    auto h12 = -log(q2 / q1) / tau;
-    auto r12 = -log(z2 / z1) / tau;
+    auto h12 = -log_q[i] / tau;
+    auto r12 = -log_z[i] / tau;
     auto alpha = h12 + r12;
-    auto expTerm = 1.0 - exp(-alpha * tau) - alpha * tau * exp(-alpha * tau) ;
+    /** exp(-alpha * tau) is the product of the two ratios */
+    auto growth = (q2 / q1) * (z2 / z1);
+    auto expTerm = 1.0 - growth - alpha * tau * growth;
     auto dfull_rpv01 = q1 * z1 * h12 * expTerm / fabs(alpha * alpha + 1e-20);
     full_rpv01 = full_rpv01 + dfull_rpv01;
     q1 = q2;
@@ -142,24 +162,54 @@ std::tuple<double,double> CDS::risky_pv01(const ChronoDate& valuation_date, cons
 
 double CDS::protection_leg_pv(const ChronoDate& valuation_date, const CreditCurve& credit_curve,
                          double recovery_rate,int num_of_steps) const
+{
+  return protection_leg_pv_impl(valuation_date, credit_curve.interpolator_, credit_curve.libor_interpolator_,
+                                recovery_rate, num_of_steps);
+}
+
+double CDS::protection_leg_pv(const ChronoDate& valuation_date, const CreditCurveOverlay& credit_curve,
+                              double recovery_rate,int num_of_steps) const
+{
+  return protection_leg_pv_impl(valuation_date, credit_curve, credit_curve.base().libor_interpolator_,
+                                recovery_rate, num_of_steps);
+}
+
+template <class Credit>
+double CDS::protection_leg_pv_impl(const ChronoDate& valuation_date, const Credit& credit_interp,
+                                   const BasicInterpolator<FlatFwd>& rates_interp, double recovery_rate,
+                                   int num_of_steps) const
 {
   auto teff = (step_in_date_ - valuation_date) / 365.0;
   auto tmat = (maturity_date_ - valuation_date) / 365.0;
   auto dt = (tmat - teff) / num_of_steps;
   auto t = teff;
-  auto credit_interp = Interpolator(credit_curve.times_,credit_curve.values_,InterpTypes::FLAT_FWD_RATES);
-  auto rates_interp = Interpolator(credit_curve.libor_curve_.times_,credit_curve.libor_curve_.dfs_,InterpTypes::FLAT_FWD_RATES);
-  auto z1 = rates_interp.interpolate(t);
-  auto q1 = credit_interp.interpolate(t);
+  std::vector<double> times(num_of_steps + 1), zs(num_of_steps + 1), qs(num_of_steps + 1);
+  times[0] = t;
+  for (int i{1}; i <= num_of_steps;++i){
+    t = t + dt;
+    times[i] = t;
+  }
+  rates_interp.interpolate(times, zs);
+  credit_interp.interpolate(times, qs);
+  /** log(q2/q1) and log(z2/z1) of every step in two batched calls */
+  std::vector<double> log_q(num_of_steps), log_z(num_of_steps);
+  for (int i{1}; i <= num_of_steps;++i){
+    log_q[i - 1] = qs[i] / qs[i - 1];
+    log_z[i - 1] = zs[i] / zs[i - 1];
+  }
+  vecmath::log(log_q, log_q);
+  vecmath::log(log_z, log_z);
+  auto z1 = zs[0];
+  auto q1 = qs[0];
   auto prot_pv = 0.0;
   auto small = 1e-8;
-  for (int i{0}; i < num_of_steps;++i){
-    t = t + dt;
-    auto z2 = rates_interp.interpolate(t);
-    auto q2 = credit_interp.interpolate(t);
-    auto h12 = -log(q2 / q1) / dt;
-    auto r12 = -log(z2 / z1) / dt;
-    auto expTerm = exp(-(r12 + h12) * dt);
+  for (int i{1}; i <= num_of_steps;++i){
+    auto z2 = zs[i];
+    auto q2 = qs[i];
+    auto h12 = -log_q[i - 1] / dt;
+    auto r12 = -log_z[i - 1] / dt;
+    /** exp(-(r12 + h12) * dt) is the product of the two ratios */
+    auto expTerm = (q2 / q1) * (z2 / z1);
     auto dprot_pv = h12 * (1.0 - expTerm) * q1 * z1 / (fabs(h12 + r12) + small);
     prot_pv += dprot_pv;
     q1 = q2;
@@ -183,6 +233,25 @@ std::tuple<double,double> CDS::value(const ChronoDate& valuation_date, const Cre
   return {full_pv, clean_pv};
 }
 
+std::tuple<double,double> CDS::value(const ChronoDate& valuation_date, const CreditCurveOverlay& credit_curve,
+                                     double recovery_rate, int num_of_steps) const
+{
+  auto [full_rpv01, clean_rpv01] = risky_pv01(valuation_date,credit_curve);
+  auto prot_pv = protection_leg_pv(valuation_date,credit_curve,recovery_rate,num_of_steps);
+  auto long_prot = long_protection_ ? 1 : -1;
+  auto full_pv = long_prot * (prot_pv - running_coupon_ * full_rpv01 * notional_);
+  auto clean_pv = long_prot * (prot_pv - running_coupon_ * clean_rpv01 * notional_);
+  return {full_pv, clean_pv};
+}
+
+double CDS::par_spread(const ChronoDate& valuation_date, const CreditCurveOverlay& credit_curve,double recovery_rate,
+                       int num_of_steps) const
+{
+  auto clean_rpv01 = std::get<1>(risky_pv01(valuation_date,credit_curve));
+  auto prot_pv = protection_leg_pv(valuation_date,credit_curve,recovery_rate,num_of_steps);
+  return prot_pv / clean_rpv01 / notional_;
+}
+
 double CDS::par_spread(const ChronoDate& valuation_date, const CreditCurve& credit_curve,double recovery_rate, int num_of_steps) const
 {
   auto rpv01 = risky_pv01(valuation_date,credit_curve);
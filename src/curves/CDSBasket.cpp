@@ -1,6 +1,7 @@
 #include <finproj/curves/CDSBasket.h>
 #include <finproj/models/StudentTCopula.h>
 #include <finproj/models/GaussCopula.h>
+#include <optional>
 
 CDSBasket::CDSBasket(const ChronoDate &step_in_date, const ChronoDate &maturity_date, double notional, double running_coupon,
                      bool long_protection, FrequencyTypes freq_type, DayCountTypes day_count_type, CalendarTypes cal_type,
@@ -19,13 +20,15 @@ std::tuple<double,double,double> CDSBasket::value_gaussian_mc(const ChronoDate&
                                                      const IborSingleCurve& libor_curve,
                                                      int num_trials,
                                                      int seed,
-                                                     const std::string& random_number_generation) const
+                                                     const std::string& random_number_generation,
+                                                     bool uniform_discounting) const
 {
   int num_credits = (int)issuer_curves.size();
   if (nth_to_default > num_credits or nth_to_default < 1)
     throw std::runtime_error("nToDefault must be 1 to num_credits");
   auto default_times = GaussCopula::default_times_gc(issuer_curves,correlation_matrix,num_trials,seed, random_number_generation);
-  auto [rpv01, prot_pv] = value_legs_mc(valuation_date,nth_to_default,default_times,issuer_curves,libor_curve);
+  auto [rpv01, prot_pv] = value_legs_mc(valuation_date,nth_to_default,default_times,issuer_curves,libor_curve,
+                                        uniform_discounting);
   auto spd = prot_pv / rpv01;
   auto value = notional_ * (prot_pv - running_coupon_ * rpv01);
   if (!long_protection_)
@@ -40,13 +43,15 @@ std::tuple<double,double,double> CDSBasket::value_student_t_mc(const ChronoDate&
                                                       const IborSingleCurve& libor_curve,
                                                       int num_trials,
                                                       int seed,
-                                                      const std::string& random_number_generation) const
+                                                      const std::string& random_number_generation,
+                                                      bool uniform_discounting) const
 {
   int num_credits = (int)issuer_curves.size();
   if (nth_to_default > num_credits or nth_to_default < 1)
     throw std::runtime_error("nToDefault must be 1 to num_credits");
   auto default_times = StudentTCopula::default_times(issuer_curves,correlation_matrix,degrees_of_freedom,num_trials,seed,random_number_generation);
-  auto [rpv01, prot_pv] = value_legs_mc(valuation_date,nth_to_default,default_times,issuer_curves,libor_curve);
+  auto [rpv01, prot_pv] = value_legs_mc(valuation_date,nth_to_default,default_times,issuer_curves,libor_curve,
+                                        uniform_discounting);
   auto spd = prot_pv / rpv01;
   auto value = notional_ * (prot_pv - running_coupon_ * rpv01);
   if (!long_protection_)
@@ -57,7 +62,8 @@ std::tuple<double,double,double> CDSBasket::value_student_t_mc(const ChronoDate&
 std::tuple<double,double> CDSBasket::value_legs_mc(const ChronoDate& valuation_date, int nth_to_default,
                                          const MatrixXd& default_times,
                                          const std::vector<CreditCurve>& issuer_curves,
-                                         const IborSingleCurve& libor_curve) const
+                                         const IborSingleCurve& libor_curve,
+                                         bool uniform_discounting) const
 {
   auto num_credits = default_times.rows();
   auto num_trials = default_times.cols()/2;
@@ -77,6 +83,12 @@ std::tuple<double,double> CDSBasket::value_legs_mc(const ChronoDate& valuation_d
   }
   averageAccrualFactor /= num_flows;
   auto tmat = (maturity_date_ - valuation_date) / 365.0;
+  /** The daily grid costs no search per trial. The relative df error is below
+  discount->max_error(), around 1e-5 or better for typical curves. A basket that has
+  matured has no default times to discount. */
+  std::optional<UniformLookup> discount{};
+  if (uniform_discounting && tmat > 0.0)
+    discount = libor_curve.uniform_lookup(tmat, daily_grid_points(tmat));
   auto rpv01 = 0.0;
   auto prot = 0.0;
   std::vector<double> assetTau(num_credits, 0.0);
@@ -102,7 +114,7 @@ std::tuple<double,double> CDSBasket::value_legs_mc(const ChronoDate& valuation_d
         }
       }
       protTrial = (1.0 - issuer_curves[assetIndex].recovery_rate_);
-      protTrial *= libor_curve.df(minTau);
+      protTrial *= discount ? discount->interpolate(minTau) : libor_curve.df(minTau);
     } else {
       auto numPaymentsIndex = int(tmat / averageAccrualFactor);
       rpv01Trial = rpv01_to_times[numPaymentsIndex];
@@ -115,3 +127,7 @@ std::tuple<double,double> CDSBasket::value_legs_mc(const ChronoDate& valuation_d
   prot = prot / num_trials;
   return {rpv01,prot};
 }
+
+std::size_t CDSBasket::daily_grid_points(double t_max){
+  return static_cast<std::size_t>(t_max * 365.0) + 2;
+}
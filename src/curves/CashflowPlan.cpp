@@ -0,0 +1,106 @@
+#include <finproj/curves/CashflowPlan.h>
+
+namespace {
+
+/** Simple forward rate over the accrual period of cashflow c projected on curve. */
+double forward_rate(const PlannedCashflow& c, const DiscountCurve& curve){
+  return (curve.df(c.start_time) / curve.df(c.end_time) - 1.0) / c.alpha;
+}
+
+}// namespace
+
+CashflowPlan::CashflowPlan(double anchor_time, std::vector<PlannedCashflow> cashflows):
+    anchor_time_{anchor_time}, cashflows_{std::move(cashflows)}{
+  std::stable_sort(cashflows_.begin(), cashflows_.end(),
+                   [](const PlannedCashflow& a, const PlannedCashflow& b) { return a.horizon() < b.horizon(); });
+}
+
+double CashflowPlan::pv(const DiscountCurve& disc_curve, const DiscountCurve& index_curve) const{
+  double sum{};
+  for (const auto& c : cashflows_) {
+    auto payment = c.amount;
+    if (c.weight != 0.0)
+      payment += c.weight * forward_rate(c, index_curve);
+    sum += payment * disc_curve.df(c.pay_time);
+  }
+  return sum / disc_curve.df(anchor_time_);
+}
+
+double CashflowPlan::pv(const DiscountCurve& curve) const{
+  return pv(curve, curve);
+}
+
+std::pair<double, double> CashflowPlan::value_and_last_node_sensitivity(const DiscountCurve& curve,
+                                                                       std::size_t first, double head) const{
+  double sum{head}, d_sum{};
+  for (auto i = first; i < cashflows_.size(); ++i) {
+    const auto& c = cashflows_[i];
+    auto payment = c.amount;
+    double d_payment{};
+    if (c.weight != 0.0) {
+      auto [df_start, d_df_start] = curve.df_and_last_node_sensitivity(c.start_time);
+      auto [df_end, d_df_end] = curve.df_and_last_node_sensitivity(c.end_time);
+      payment += c.weight * (df_start / df_end - 1.0) / c.alpha;
+      d_payment = c.weight * (d_df_start - df_start / df_end * d_df_end) / df_end / c.alpha;
+    }
+    auto [df, d_df] = curve.df_and_last_node_sensitivity(c.pay_time);
+    sum += payment * df;
+    d_sum += d_payment * df + payment * d_df;
+  }
+  auto [df_anchor, d_df_anchor] = curve.df_and_last_node_sensitivity(anchor_time_);
+  auto v = sum / df_anchor;
+  return {v, (d_sum - v * d_df_anchor) / df_anchor};
+}
+
+double CashflowPlan::value_and_node_sensitivities(const DiscountCurve& curve, std::span<double> grad,
+                                                  std::span<double> work) const{
+  auto add = [&](double t, double weight) {
+    curve.df_sensitivities(t, work);
+    for (size_t j{0}; j < grad.size(); ++j)
+      grad[j] += weight * work[j];
+  };
+  std::fill(grad.begin(), grad.end(), 0.0);
+  auto df_anchor = curve.df(anchor_time_);
+  double v{};
+  for (const auto& c : cashflows_) {
+    auto df_pmnt = curve.df(c.pay_time) / df_anchor;
+    auto payment = c.amount;
+    if (c.weight != 0.0) {
+      auto df_start = curve.df(c.start_time);
+      auto df_end = curve.df(c.end_time);
+      payment += c.weight * (df_start / df_end - 1.0) / c.alpha;
+      auto scale = c.weight * df_pmnt / c.alpha;
+      add(c.start_time, scale / df_end);
+      add(c.end_time, -scale * df_start / (df_end * df_end));
+    }
+    v += payment * df_pmnt;
+    add(c.pay_time, payment / df_anchor);
+  }
+  add(anchor_time_, -v / df_anchor);
+  return v;
+}
+
+std::size_t CashflowPlan::first_after(double t) const{
+  auto it = std::partition_point(cashflows_.begin(), cashflows_.end(),
+                                 [t](const PlannedCashflow& c) { return !(c.horizon() > t); });
+  return static_cast<std::size_t>(it - cashflows_.begin());
+}
+
+double CashflowPlan::head_value(const DiscountCurve& curve, std::size_t first) const{
+  double head{};
+  for (size_t i{0}; i < first; ++i) {
+    const auto& c = cashflows_[i];
+    auto payment = c.amount;
+    if (c.weight != 0.0)
+      payment += c.weight * forward_rate(c, curve);
+    head += payment * curve.df(c.pay_time);
+  }
+  return head;
+}
+
+void CashflowPlan::scale(double factor){
+  for (auto& c : cashflows_) {
+    c.amount *= factor;
+    c.weight *= factor;
+  }
+}
@@ -1,5 +1,6 @@
 #include <finproj/curves/CreditCurve.h>
 #include <finproj/curves/CDS.h>
+#include <finproj/curves/CurveSnapshot.h>
 #include <ranges>
 #include <iostream>
 #include <boost/math/tools/roots.hpp>
@@ -8,12 +9,28 @@
 CreditCurve::CreditCurve(const ChronoDate& valuation_date, const std::string& ticker, const std::vector<CDS>& cds_contracts,
             const IborSingleCurve& libor_curve,double recovery_rate,
             InterpTypes interp_type):
- libor_curve_{libor_curve},recovery_rate_{recovery_rate},ticker_{ticker},valuation_date_{valuation_date},
+ libor_curve_{libor_curve},libor_interpolator_{libor_curve.times_,libor_curve.dfs_},
+ recovery_rate_{recovery_rate},ticker_{ticker},valuation_date_{valuation_date},
                                                     cds_contracts_{cds_contracts}, interp_type_{interp_type}
 {
   build_curve();
 }
 
+CreditCurve::CreditCurve(const CurveView& view, const IborSingleCurve& libor_curve,
+                         const std::vector<CDS>& cds_contracts):
+ times_(view.times().begin(), view.times().end()),values_(view.values().begin(), view.values().end()),
+ libor_curve_{libor_curve},libor_interpolator_{libor_curve.times_,libor_curve.dfs_},
+ recovery_rate_{view.recovery_rate()},ticker_{view.ticker()},
+ valuation_date_{view.valuation_date()},cds_contracts_{cds_contracts},interp_type_{view.interp_type()}
+{
+  if (view.kind() != CurveView::Kind::SURVIVAL)
+    throw std::runtime_error("Snapshot curve " + ticker_ + " is not a survival curve");
+  interpolator_ = BasicInterpolator<FlatFwd>{interp_type_};
+  interpolator_.reserve(times_.size());
+  for (size_t i{0}; i < times_.size(); ++i)
+    interpolator_.push_node(times_[i], values_[i]);
+}
+
 double CreditCurve::get_rec_rate() const { return recovery_rate_;}
 void CreditCurve::set_rec_rate(double rate) { recovery_rate_ = rate;}
 
@@ -38,14 +55,19 @@ void CreditCurve::build_curve() {
   auto num_times = cds_contracts_.size();
   times_.clear();values_.clear();
   times_.push_back(0.0);values_.push_back(1.0);
+  interpolator_ = BasicInterpolator<FlatFwd>{};
+  interpolator_.reserve(num_times + 1);
+  interpolator_.push_node(0.0, 1.0);
   for (size_t i{0}; i < num_times;++i){
     auto maturity_date = cds_contracts_[i].get_maturity_date();
     auto tmat = (maturity_date - valuation_date_) / 365.0;
     auto q = values_[i];
     times_.push_back(tmat);
     values_.push_back(q);
+    interpolator_.push_node(tmat, q);
     auto _g = [&](const double q) {
       (*this).values_.back() = q;
+      (*this).interpolator_.set_last_value(q);
       auto [full_pv, clean_pv] = cds_contracts_[i].value(valuation_date_, *this, recovery_rate_);
       if (clean_pv == 0.0) clean_pv = 1e-12;
       return clean_pv;
@@ -82,7 +104,21 @@ void CreditCurve::validate() const {
 
 double CreditCurve::surv_prob(const ChronoDate& dt) const{
   auto t = (dt - valuation_date_) / 365.0;
-  Interpolator interpolator{times_, values_, InterpTypes::FLAT_FWD_RATES};
-  auto q = interpolator.interpolate(t);
+  auto q = interpolator_.interpolate(t);
   return q;
 }
+
+std::vector<double> CreditCurve::surv_prob(const std::vector<ChronoDate>& dts) const{
+  std::vector<double> times{};
+  times.reserve(dts.size());
+  for (const auto& dt : dts){
+    times.push_back((dt - valuation_date_) / 365.0);
+  }
+  std::vector<double> qs(dts.size());
+  interpolator_.interpolate(times, qs);
+  return qs;
+}
+
+UniformLookup CreditCurve::uniform_lookup(double t_max, std::size_t num_points) const{
+  return UniformLookup::sample(interpolator_, t_max, num_points, times_);
+}
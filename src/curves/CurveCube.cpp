@@ -0,0 +1,145 @@
+#include <finproj/curves/CurveCube.h>
+#include <finproj/utils/Misc.h>
+#include <finproj/utils/VecMath.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+std::vector<double> node_times(const ChronoDate& valuation_date, const std::vector<ChronoDate>& zero_dates,
+                               DayCountTypes day_count_type){
+  std::vector<double> times{};
+  times.reserve(zero_dates.size());
+  auto day_count = DayCount(day_count_type);
+  for (const auto& d : zero_dates)
+    times.push_back(std::get<0>(day_count.year_frac(valuation_date, d, FrequencyTypes::ANNUAL)));
+  return times;
+}
+
+}// namespace
+
+CurveCube::CurveCube(const std::vector<double>& times, Eigen::MatrixXd zero_rates,
+                     FrequencyTypes freq_type, InterpTypes interp_type):
+times_{times},interp_type_{interp_type},values_{std::move(zero_rates)}{
+  if (times_.empty())
+    throw std::runtime_error("Times has zero length");
+  if (static_cast<Eigen::Index>(times_.size()) != values_.cols())
+    throw std::runtime_error("Zero rates need one column per node time");
+  if (!(times_[0] > 0.0) || std::adjacent_find(times_.begin(), times_.end(), std::greater_equal<double>()) != times_.end())
+    throw std::runtime_error("Node times must be positive and increasing");
+  if (interp_type_ != InterpTypes::FLAT_FWD_RATES && interp_type_ != InterpTypes::LINEAR_ZERO_RATES)
+    throw std::runtime_error("Curve cubes only support flat forward and linear zero rate interpolation");
+
+  /** -log(df) for the whole cube, with one batched log for the compounded rates */
+  auto f = static_cast<double>(static_cast<int>(freq_type));
+  auto all = std::span(values_.data(), static_cast<std::size_t>(values_.size()));
+  switch (freq_type) {
+    case FrequencyTypes::CONTINUOUS:
+      for (Eigen::Index j{0}; j < num_nodes(); ++j)
+        values_.col(j) *= fmax(times_[j], gSmall);
+      break;
+    case FrequencyTypes::SIMPLE:
+      for (Eigen::Index j{0}; j < num_nodes(); ++j)
+        values_.col(j) = (values_.col(j).array() * fmax(times_[j], gSmall) + 1.0).matrix();
+      vecmath::log(all, all);
+      break;
+    case FrequencyTypes::ANNUAL:
+    case FrequencyTypes::SEMI_ANNUAL:
+    case FrequencyTypes::QUARTERLY:
+    case FrequencyTypes::MONTHLY:
+      values_ = (values_.array() / f + 1.0).matrix();
+      vecmath::log(all, all);
+      for (Eigen::Index j{0}; j < num_nodes(); ++j)
+        values_.col(j) *= f * fmax(times_[j], gSmall);
+      break;
+    default:
+      throw std::runtime_error("Unknown frequency");
+  }
+  if (interp_type_ == InterpTypes::LINEAR_ZERO_RATES)
+    for (Eigen::Index j{0}; j < num_nodes(); ++j)
+      values_.col(j) /= times_[j];
+}
+
+CurveCube::CurveCube(const ChronoDate& valuation_date, const std::vector<ChronoDate>& zero_dates,
+                     const Eigen::MatrixXd& zero_rates, FrequencyTypes freq_type, DayCountTypes day_count_type,
+                     InterpTypes interp_type):
+CurveCube(node_times(valuation_date, zero_dates, day_count_type), zero_rates, freq_type, interp_type){}
+
+CurveCube::Weights CurveCube::weights(double t) const{
+  /** Mirrors the segments SegmentTable fits for the two schemes: the first interval
+  extends backwards, flat forwards extrapolate the last interval and linear zero
+  rates hold the first and last zero rate flat. */
+  auto n = times_.size();
+  auto zero_rates = interp_type_ == InterpTypes::LINEAR_ZERO_RATES;
+  if (n == 1)
+    return {0, 0, 1.0, 0.0, zero_rates ? t : 1.0};
+  auto i = SegmentTable::find_segment(times_, t);
+  if (zero_rates) {
+    if (i <= 1)
+      return {1, 1, 1.0, 0.0, t};
+    if (i >= n)
+      return {static_cast<Eigen::Index>(n - 1), static_cast<Eigen::Index>(n - 1), 1.0, 0.0, t};
+  }
+  auto k = std::clamp<std::size_t>(i, 1, n - 1);
+  auto u = (t - times_[k - 1]) / (times_[k] - times_[k - 1]);
+  return {static_cast<Eigen::Index>(k - 1), static_cast<Eigen::Index>(k), 1.0 - u, u, zero_rates ? t : 1.0};
+}
+
+Eigen::MatrixXd CurveCube::dfs() const{
+  Eigen::MatrixXd out{};
+  df(times_, out);
+  return out;
+}
+
+void CurveCube::df(std::span<const double> times, Eigen::MatrixXd& out) const{
+  auto num_times = static_cast<Eigen::Index>(times.size());
+  if (out.rows() != num_scenarios() || out.cols() != num_times)
+    out.resize(num_scenarios(), num_times);
+  for (Eigen::Index k{0}; k < num_times; ++k) {
+    auto t = times[k];
+    if (t < SegmentTable::small) {
+      out.col(k).setZero();
+      continue;
+    }
+    auto w = weights(t);
+    out.col(k) = (w.scale * w.w0) * values_.col(w.k0) + (w.scale * w.w1) * values_.col(w.k1);
+  }
+  vecmath::exp_neg(std::span(out.data(), static_cast<std::size_t>(out.size())));
+}
+
+Eigen::MatrixXd CurveCube::df(std::span<const double> times) const{
+  Eigen::MatrixXd out{};
+  df(times, out);
+  return out;
+}
+
+double CurveCube::df(Eigen::Index scenario, double time) const{
+  if (time < SegmentTable::small)
+    return 1.0;
+  auto w = weights(time);
+  return std::exp(-w.scale * (w.w0 * values_(scenario, w.k0) + w.w1 * values_(scenario, w.k1)));
+}
+
+Eigen::VectorXd CurveCube::pv(std::span<const double> times, std::span<const double> amounts) const{
+  if (times.size() != amounts.size())
+    throw std::runtime_error("Times and amounts have different lengths");
+  /** One scenario column at a time, so the scenarios by times matrix is never formed */
+  Eigen::VectorXd pvs = Eigen::VectorXd::Zero(num_scenarios());
+  Eigen::VectorXd column(num_scenarios());
+  auto column_span = std::span(column.data(), static_cast<std::size_t>(column.size()));
+  for (std::size_t k{0}; k < times.size(); ++k) {
+    auto t = times[k];
+    if (t < SegmentTable::small) {
+      pvs.array() += amounts[k];
+      continue;
+    }
+    auto w = weights(t);
+    column = (w.scale * w.w0) * values_.col(w.k0) + (w.scale * w.w1) * values_.col(w.k1);
+    vecmath::exp_neg(column_span);
+    pvs += amounts[k] * column;
+  }
+  return pvs;
+}
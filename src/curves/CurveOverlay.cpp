@@ -0,0 +1,147 @@
+#include <finproj/curves/CurveOverlay.h>
+#include <finproj/curves/CDS.h>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+std::vector<double> pillars_after_zero(const std::vector<double>& times){
+  std::vector<double> pillars{};
+  for (auto t : times)
+    if (t > 0.0)
+      pillars.push_back(t);
+  return pillars;
+}
+
+}// namespace
+
+ZeroShift::ZeroShift(double t_left, double t_key, double t_right, double bump):
+t_left_{t_left},t_key_{t_key},t_right_{t_right},bump_{bump}{
+  if (t_left_ > t_key_ || t_right_ < t_key_)
+    throw std::runtime_error("Key rate shift needs t_left <= t_key <= t_right");
+}
+
+ZeroShift ZeroShift::parallel(double bump){
+  return {0.0, 0.0, 0.0, bump};
+}
+
+ZeroShift ZeroShift::key_rate(double t_left, double t_key, double t_right, double bump){
+  return {t_left, t_key, t_right, bump};
+}
+
+std::vector<ZeroShift> ZeroShift::key_rates(std::span<const double> pillars, double bump){
+  std::vector<ZeroShift> shifts{};
+  shifts.reserve(pillars.size());
+  for (std::size_t i{0}; i < pillars.size(); ++i) {
+    auto t_left = i == 0 ? pillars[i] : pillars[i - 1];
+    auto t_right = i + 1 == pillars.size() ? pillars[i] : pillars[i + 1];
+    shifts.push_back(key_rate(t_left, pillars[i], t_right, bump));
+  }
+  return shifts;
+}
+
+double ZeroShift::operator()(double t) const{
+  if (t < t_key_) {
+    if (t_left_ == t_key_)
+      return bump_;
+    return t <= t_left_ ? 0.0 : bump_ * (t - t_left_) / (t_key_ - t_left_);
+  }
+  if (t_right_ == t_key_)
+    return bump_;
+  return t >= t_right_ ? 0.0 : bump_ * (t_right_ - t) / (t_right_ - t_key_);
+}
+
+void ZeroShift::apply(std::span<const double> ts, std::span<double> values) const{
+  if (bump_ == 0.0)
+    return;
+  for (std::size_t i{0}; i < ts.size(); ++i) {
+    auto s = (*this)(ts[i]);
+    // a key rate triangle leaves everything outside its wings untouched
+    if (s != 0.0)
+      values[i] *= std::exp(-s * ts[i]);
+  }
+}
+
+DiscountCurveOverlay::DiscountCurveOverlay(const DiscountCurve& base, const ZeroShift& shift):
+base_{&base},shift_{shift}{}
+
+DiscountCurveOverlay DiscountCurveOverlay::parallel(const DiscountCurve& base, double bump){
+  return {base, ZeroShift::parallel(bump)};
+}
+
+std::vector<DiscountCurveOverlay> DiscountCurveOverlay::key_rates(const DiscountCurve& base, double bump){
+  std::vector<DiscountCurveOverlay> overlays{};
+  for (const auto& shift : ZeroShift::key_rates(pillars_after_zero(base.times_), bump))
+    overlays.emplace_back(base, shift);
+  return overlays;
+}
+
+double DiscountCurveOverlay::df(double time) const{
+  return base_->df(time) * std::exp(-shift_(time) * time);
+}
+
+double DiscountCurveOverlay::df(const ChronoDate& date) const{
+  double t{};
+  base_->times(std::span(&date, 1), std::span(&t, 1));
+  return df(t);
+}
+
+void DiscountCurveOverlay::df(std::span<const double> times, std::span<double> out) const{
+  base_->df(times, out);
+  shift_.apply(times, out);
+}
+
+void DiscountCurveOverlay::df(std::span<const ChronoDate> dates, std::span<double> out) const{
+  std::vector<double> times(dates.size());
+  base_->times(dates, times);
+  df(times, out);
+}
+
+UniformLookup DiscountCurveOverlay::uniform_lookup(double t_max, std::size_t num_points) const{
+  return UniformLookup::sample(*this, t_max, num_points, base_->times_);
+}
+
+CreditCurveOverlay::CreditCurveOverlay(const CreditCurve& base, const ZeroShift& shift):
+base_{&base},shift_{shift}{}
+
+CreditCurveOverlay CreditCurveOverlay::parallel(const CreditCurve& base, double bump){
+  return {base, ZeroShift::parallel(bump)};
+}
+
+CreditCurveOverlay CreditCurveOverlay::spread_shift(const CreditCurve& base, double bump){
+  return {base, ZeroShift::parallel(bump / (1.0 - base.recovery_rate_))};
+}
+
+std::vector<CreditCurveOverlay> CreditCurveOverlay::key_rates(const CreditCurve& base, double bump){
+  std::vector<CreditCurveOverlay> overlays{};
+  for (const auto& shift : ZeroShift::key_rates(pillars_after_zero(base.times_), bump))
+    overlays.emplace_back(base, shift);
+  return overlays;
+}
+
+double CreditCurveOverlay::interpolate(double t) const{
+  return base_->interpolator_.interpolate(t) * std::exp(-shift_(t) * t);
+}
+
+void CreditCurveOverlay::interpolate(std::span<const double> ts, std::span<double> out) const{
+  base_->interpolator_.interpolate(ts, out);
+  shift_.apply(ts, out);
+}
+
+double CreditCurveOverlay::surv_prob(const ChronoDate& dt) const{
+  return interpolate((dt - base_->valuation_date()) / 365.0);
+}
+
+std::vector<double> CreditCurveOverlay::surv_prob(const std::vector<ChronoDate>& dts) const{
+  std::vector<double> times{};
+  times.reserve(dts.size());
+  for (const auto& dt : dts)
+    times.push_back((dt - base_->valuation_date()) / 365.0);
+  std::vector<double> qs(dts.size());
+  interpolate(times, qs);
+  return qs;
+}
+
+UniformLookup CreditCurveOverlay::uniform_lookup(double t_max, std::size_t num_points) const{
+  return UniformLookup::sample(*this, t_max, num_points, base_->times_);
+}
@@ -0,0 +1,349 @@
+#include <finproj/curves/CurveSnapshot.h>
+#include <finproj/curves/CDS.h>
+#include <finproj/curves/CreditCurve.h>
+#include <finproj/curves/DiscountCurve.h>
+#include <finproj/utils/DayCount.h>
+#include <finproj/utils/VecMath.h>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char magic[8] = {'F', 'P', 'C', 'U', 'R', 'V', 'E', 'S'};
+constexpr std::size_t header_size = 32;
+constexpr std::size_t record_size = 64;
+constexpr std::size_t doubles_per_segment = 5;
+
+static_assert(sizeof(SegmentTable::Segment) == doubles_per_segment * sizeof(double) &&
+              alignof(SegmentTable::Segment) == alignof(double),
+              "Segments are mapped directly from the snapshot");
+
+/** Little-endian encoder for the writer, independent of the host byte order. */
+class Encoder {
+ public:
+  void u32(std::uint32_t v) {
+    for (int i{0}; i < 4; ++i)
+      bytes_.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+  }
+  void u64(std::uint64_t v) {
+    for (int i{0}; i < 8; ++i)
+      bytes_.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+  }
+  void f64(double v) { u64(std::bit_cast<std::uint64_t>(v)); }
+  void raw(std::string_view s) { bytes_.insert(bytes_.end(), s.begin(), s.end()); }
+  void align8() {
+    while (bytes_.size() % 8 != 0)
+      bytes_.push_back('\0');
+  }
+  [[nodiscard]] std::vector<char> take() { return std::move(bytes_); }
+
+ private:
+  std::vector<char> bytes_{};
+};
+
+std::uint32_t encode_date(const ChronoDate& date){
+  return static_cast<std::uint32_t>(date.year() * 10000) + date.month() * 100 + date.day();
+}
+
+ChronoDate decode_date(std::uint32_t yyyymmdd){
+  return ChronoDate(static_cast<int>(yyyymmdd / 10000), (yyyymmdd / 100) % 100, yyyymmdd % 100);
+}
+
+bool known_interp_type(std::uint32_t type){
+  switch (static_cast<InterpTypes>(type)) {
+    case InterpTypes::FLAT_FWD_RATES:
+    case InterpTypes::LINEAR_FWD_RATES:
+    case InterpTypes::LINEAR_ZERO_RATES:
+    case InterpTypes::FINCUBIC_ZERO_RATES:
+    case InterpTypes::NATCUBIC_LOG_DISCOUNT:
+    case InterpTypes::NATCUBIC_ZERO_RATES:
+    case InterpTypes::PCHIP_ZERO_RATES:
+    case InterpTypes::PCHIP_LOG_DISCOUNT:
+      return true;
+  }
+  return false;
+}
+
+bool known_day_count_type(std::uint32_t type){
+  return type <= static_cast<std::uint32_t>(DayCountTypes::SIMPLE);
+}
+
+bool known_freq_type(std::int16_t type){
+  switch (static_cast<FrequencyTypes>(type)) {
+    case FrequencyTypes::ZERO:
+    case FrequencyTypes::SIMPLE:
+    case FrequencyTypes::ANNUAL:
+    case FrequencyTypes::SEMI_ANNUAL:
+    case FrequencyTypes::TRI_ANNUAL:
+    case FrequencyTypes::QUARTERLY:
+    case FrequencyTypes::MONTHLY:
+    case FrequencyTypes::CONTINUOUS:
+      return true;
+  }
+  return false;
+}
+
+}// namespace
+
+double CurveView::exponent(std::size_t segment, double t) const{
+  const auto& seg = segments_[segment];
+  switch (interp_type_) {
+    case InterpTypes::FLAT_FWD_RATES: return FlatFwd::exponent(seg, t);
+    case InterpTypes::LINEAR_ZERO_RATES: return LinearZero::exponent(seg, t);
+    case InterpTypes::LINEAR_FWD_RATES: return LinearFwd::exponent(seg, t);
+    case InterpTypes::NATCUBIC_LOG_DISCOUNT:
+    case InterpTypes::PCHIP_LOG_DISCOUNT: return CubicLog::exponent(seg, t);
+    default: return CubicZero::exponent(seg, t);
+  }
+}
+
+double CurveView::value(double t) const{
+  if (t < SegmentTable::small)
+    return 1.0;
+  return std::exp(-exponent(SegmentTable::find_segment(times_, t), t));
+}
+
+void CurveView::value(std::span<const double> ts, std::span<double> out) const{
+  if (ts.size() != out.size())
+    throw std::runtime_error("Times and output have different lengths");
+  for (std::size_t k{0}; k < ts.size(); ++k) {
+    auto t = ts[k];
+    out[k] = t < SegmentTable::small ? 0.0 : exponent(SegmentTable::find_segment(times_, t), t);
+  }
+  vecmath::exp_neg(out);
+}
+
+double CurveView::value(const ChronoDate& date) const{
+  if (kind_ == Kind::SURVIVAL)
+    return value((date - valuation_date_) / 365.0);
+  return value(std::get<0>(DayCount(DayCountTypes::ACT_ACT_ISDA).year_frac(valuation_date_, date, FrequencyTypes::ANNUAL)));
+}
+
+CurveSnapshot::CurveSnapshot(const std::string& path){
+  if constexpr (std::endian::native != std::endian::little)
+    throw std::runtime_error("Curve snapshots can only be mapped on little-endian hosts");
+  auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open curve snapshot " + path);
+  struct stat status{};
+  if (::fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(header_size)) {
+    ::close(fd);
+    throw std::runtime_error("Curve snapshot " + path + " is truncated");
+  }
+  size_ = static_cast<std::size_t>(status.st_size);
+  auto* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+    throw std::runtime_error("Cannot map curve snapshot " + path);
+  data_ = static_cast<const std::byte*>(mapping);
+
+  try {
+    views_ = parse({data_, size_});
+  } catch (const std::runtime_error& ex) {
+    unmap();
+    throw std::runtime_error("Curve snapshot " + path + ": " + ex.what());
+  } catch (...) {
+    unmap();
+    throw;
+  }
+}
+
+std::vector<CurveView> CurveSnapshot::parse(std::span<const std::byte> image){
+  if constexpr (std::endian::native != std::endian::little)
+    throw std::runtime_error("Curve snapshots can only be mapped on little-endian hosts");
+  const auto* data = image.data();
+  auto size = image.size();
+  if (size < header_size)
+    throw std::runtime_error("truncated");
+  std::vector<CurveView> views{};
+  auto read_u32 = [&](std::size_t offset) {
+    std::uint32_t v;
+    std::memcpy(&v, data + offset, sizeof v);
+    return v;
+  };
+  auto read_u64 = [&](std::size_t offset) {
+    std::uint64_t v;
+    std::memcpy(&v, data + offset, sizeof v);
+    return v;
+  };
+  auto array = [&](std::uint64_t offset, std::uint64_t count, std::size_t elem_size) {
+    if (offset % 8 != 0 || offset > size || count > (size - offset) / elem_size)
+      throw std::runtime_error("array outside the image");
+    return data + offset;
+  };
+  if (std::memcmp(data, magic, sizeof magic) != 0)
+    throw std::runtime_error("not a curve snapshot");
+  if (read_u32(8) != format_version)
+    throw std::runtime_error("unsupported format version");
+  auto num_curves = read_u32(12);
+  auto directory = read_u64(16);
+  if (read_u64(24) != size)
+    throw std::runtime_error("truncated");
+  array(directory, num_curves, record_size);
+
+  views.reserve(num_curves);
+  for (std::uint32_t i{0}; i < num_curves; ++i) {
+    auto record = static_cast<std::size_t>(directory) + i * record_size;
+    auto kind = read_u32(record);
+    auto interp_type = read_u32(record + 4);
+    auto num_points = read_u32(record + 12);
+    auto conventions = read_u32(record + 60);
+    auto freq_type = static_cast<std::int16_t>(conventions >> 16);
+    if (kind != static_cast<std::uint32_t>(CurveView::Kind::DISCOUNT) &&
+        kind != static_cast<std::uint32_t>(CurveView::Kind::SURVIVAL))
+      throw std::runtime_error("unknown curve kind");
+    if (!known_interp_type(interp_type) || !known_day_count_type(conventions & 0xffff) ||
+        !known_freq_type(freq_type) || num_points == 0)
+      throw std::runtime_error("invalid curve record");
+    CurveView view{};
+    view.kind_ = static_cast<CurveView::Kind>(kind);
+    view.interp_type_ = static_cast<InterpTypes>(interp_type);
+    view.day_count_type_ = static_cast<DayCountTypes>(conventions & 0xffff);
+    view.freq_type_ = static_cast<FrequencyTypes>(freq_type);
+    view.valuation_date_ = decode_date(read_u32(record + 8));
+    std::memcpy(&view.recovery_rate_, data + record + 16, sizeof(double));
+    auto times = array(read_u64(record + 24), num_points, sizeof(double));
+    auto values = array(read_u64(record + 32), num_points, sizeof(double));
+    auto segments = array(read_u64(record + 40), num_points + 1, sizeof(SegmentTable::Segment));
+    auto ticker_length = read_u32(record + 56);
+    auto ticker = array(read_u64(record + 48), ticker_length, 1);
+    view.times_ = {reinterpret_cast<const double*>(times), num_points};
+    view.values_ = {reinterpret_cast<const double*>(values), num_points};
+    view.segments_ = {reinterpret_cast<const SegmentTable::Segment*>(segments), num_points + 1};
+    view.ticker_ = {reinterpret_cast<const char*>(ticker), ticker_length};
+    views.push_back(view);
+  }
+  return views;
+}
+
+CurveSnapshot::CurveSnapshot(CurveSnapshot&& other) noexcept:
+data_{std::exchange(other.data_, nullptr)},size_{std::exchange(other.size_, 0)},views_{std::move(other.views_)}{}
+
+CurveSnapshot& CurveSnapshot::operator=(CurveSnapshot&& other) noexcept{
+  if (this != &other) {
+    unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    views_ = std::move(other.views_);
+  }
+  return *this;
+}
+
+CurveSnapshot::~CurveSnapshot(){
+  unmap();
+}
+
+void CurveSnapshot::unmap(){
+  if (data_ != nullptr)
+    ::munmap(const_cast<std::byte*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+  views_.clear();
+}
+
+const CurveView* CurveSnapshot::find(CurveView::Kind kind, std::string_view ticker) const{
+  for (const auto& view : views_)
+    if (view.kind() == kind && view.ticker() == ticker)
+      return &view;
+  return nullptr;
+}
+
+void CurveSnapshotWriter::add(const DiscountCurve& curve, std::string_view name){
+  add(CurveView::Kind::DISCOUNT, curve.interpolator_.table(), curve.day_count_type_, curve.freq_type_,
+      curve.valuation_date_, 0.0, name);
+}
+
+void CurveSnapshotWriter::add(const CreditCurve& curve){
+  add(CurveView::Kind::SURVIVAL, curve.interpolator_.table(), DayCountTypes{}, FrequencyTypes{},
+      curve.valuation_date(), curve.recovery_rate_, curve.ticker_);
+}
+
+void CurveSnapshotWriter::add(CurveView::Kind kind, const SegmentTable& table, DayCountTypes day_count_type,
+                              FrequencyTypes freq_type, const ChronoDate& valuation_date,
+                              double recovery_rate, std::string_view ticker){
+  if (table.times().empty())
+    throw std::runtime_error("Cannot write a curve without nodes to a snapshot");
+  Entry entry{kind, table.type(), day_count_type, freq_type, valuation_date, recovery_rate, std::string{ticker}};
+  entry.times.assign(table.times().begin(), table.times().end());
+  entry.values.assign(table.dfs().begin(), table.dfs().end());
+  entry.segments.assign(table.segments().begin(), table.segments().end());
+  entries_.push_back(std::move(entry));
+}
+
+void CurveSnapshotWriter::write(const std::string& path) const{
+  auto image = bytes();
+  // written next to the target and renamed over it, so readers never see half a file
+  auto tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file)
+      throw std::runtime_error("Cannot write curve snapshot " + path);
+    file.write(image.data(), static_cast<std::streamsize>(image.size()));
+    if (!file)
+      throw std::runtime_error("Cannot write curve snapshot " + path);
+  }
+  std::filesystem::rename(tmp_path, path);
+}
+
+std::vector<char> CurveSnapshotWriter::bytes() const{
+  /** Offsets are laid out first so that the header and directory can be written in
+  one sequential pass ahead of the arrays. */
+  struct Offsets {
+    std::uint64_t times{}, values{}, segments{}, ticker{};
+  };
+  auto round8 = [](std::uint64_t n) { return (n + 7) / 8 * 8; };
+  std::vector<Offsets> offsets(entries_.size());
+  std::uint64_t end = header_size + record_size * entries_.size();
+  for (std::size_t i{0}; i < entries_.size(); ++i) {
+    const auto& entry = entries_[i];
+    offsets[i].times = end;
+    offsets[i].values = offsets[i].times + entry.times.size() * sizeof(double);
+    offsets[i].segments = offsets[i].values + entry.values.size() * sizeof(double);
+    offsets[i].ticker = offsets[i].segments + entry.segments.size() * sizeof(SegmentTable::Segment);
+    end = round8(offsets[i].ticker + entry.ticker.size());
+  }
+
+  Encoder out{};
+  out.raw(std::string_view{magic, sizeof magic});
+  out.u32(CurveSnapshot::format_version);
+  out.u32(static_cast<std::uint32_t>(entries_.size()));
+  out.u64(header_size);
+  out.u64(end);
+  for (std::size_t i{0}; i < entries_.size(); ++i) {
+    const auto& entry = entries_[i];
+    out.u32(static_cast<std::uint32_t>(entry.kind));
+    out.u32(static_cast<std::uint32_t>(entry.interp_type));
+    out.u32(encode_date(entry.valuation_date));
+    out.u32(static_cast<std::uint32_t>(entry.times.size()));
+    out.f64(entry.recovery_rate);
+    out.u64(offsets[i].times);
+    out.u64(offsets[i].values);
+    out.u64(offsets[i].segments);
+    out.u64(offsets[i].ticker);
+    out.u32(static_cast<std::uint32_t>(entry.ticker.size()));
+    out.u32(static_cast<std::uint32_t>(entry.day_count_type) |
+            static_cast<std::uint32_t>(static_cast<std::uint16_t>(entry.freq_type)) << 16);
+  }
+  for (const auto& entry : entries_) {
+    for (auto t : entry.times)
+      out.f64(t);
+    for (auto v : entry.values)
+      out.f64(v);
+    for (const auto& seg : entry.segments)
+      for (auto x : {seg.t0, seg.y, seg.b, seg.c, seg.d})
+        out.f64(x);
+    out.raw(entry.ticker);
+    out.align8();
+  }
+  return out.take();
+}
@@ -1,11 +1,42 @@
 #include "finproj/utils/Schedule.h"
 #include <algorithm>
 #include <cmath>
+#include <finproj/curves/CurveSnapshot.h>
 #include <finproj/curves/DiscountCurve.h>
 #include <finproj/utils/Misc.h>
+#include <finproj/utils/VecMath.h>
+#include <array>
 #include <tuple>
 #include <ranges>
 
+namespace {
+
+/** Turns the discount factors in values into zero rates of freq_type in place, time(i)
+giving the year fraction of entry i. */
+template <class Time>
+void dfs_to_zeros(std::span<double> values, Time time, FrequencyTypes freq_type){
+  auto f = static_cast<double>(static_cast<int>(freq_type));
+  if (freq_type == FrequencyTypes::SIMPLE){
+    for (size_t i = 0; i < values.size(); ++i)
+      values[i] = (1.0 / values[i] - 1.0) / fmax(time(i), gSmall);
+    return;
+  }
+  vecmath::log(values, values);
+  if (freq_type == FrequencyTypes::CONTINUOUS){
+    for (size_t i = 0; i < values.size(); ++i)
+      values[i] = -values[i] / fmax(time(i), gSmall);
+    return;
+  }
+  /** df^(-1/(f*t)) - 1 = expm1(-log(df)/(f*t)), which keeps its digits for small rates */
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i] = -values[i] / (fmax(time(i), gSmall) * f);
+  vecmath::expm1(values, values);
+  for (auto& z : values)
+    z *= f;
+}
+
+}// namespace
+
 DiscountCurve::DiscountCurve(const ChronoDate& valuation_date,
               FrequencyTypes freq_type,
               DayCountTypes day_count_type,
@@ -54,23 +85,49 @@ DiscountCurve::DiscountCurve(const ChronoDate& valuation_date,
   interpolator_ = Interpolator(times_,dfs_,interp_type_);
 }
 
+DiscountCurve::DiscountCurve(const CurveView& view):
+  valuation_date_{view.valuation_date()},
+  interp_type_{view.interp_type()},
+  dfs_(view.values().begin(), view.values().end()),
+  times_(view.times().begin(), view.times().end()),
+  num_points_{static_cast<int>(view.times().size())},
+  freq_type_{view.freq_type()},
+  day_count_type_{view.day_count_type()}{
+  if (view.kind() != CurveView::Kind::DISCOUNT)
+    throw std::runtime_error("Snapshot curve " + std::string{view.ticker()} + " is not a discount curve");
+  interpolator_ = Interpolator(times_,dfs_,interp_type_);
+}
+
 std::vector<double> DiscountCurve::zero_to_df(const std::vector<double>& rates, const std::vector<double>& times,
                                              FrequencyTypes freq_type) const{
-  std::vector<double> df{};
-  df.reserve(rates.size());
-  auto f = static_cast<int>(freq_type);
-  for (size_t i = 0; i < rates.size(); ++i){
-      auto t = fmax(times[i],gSmall );
-      if (freq_type == FrequencyTypes::CONTINUOUS)
-        df.push_back(-exp(rates[i] * t));
-      else if (freq_type == FrequencyTypes::SIMPLE)
-        df.push_back(1.0 / (1.0 + rates[i] * t));
-      else if (freq_type == FrequencyTypes::ANNUAL ||
-               freq_type == FrequencyTypes::SEMI_ANNUAL ||
-               freq_type == FrequencyTypes::QUARTERLY ||
-               freq_type == FrequencyTypes::MONTHLY){
-        df.push_back(1.0 / pow(1.0 + rates[i] / f, f * t));
-      } else throw std::runtime_error("Unknown frequency");
+  if (rates.size() != times.size())
+      throw std::runtime_error("rates and times have different sizes");
+  auto f = static_cast<double>(static_cast<int>(freq_type));
+  std::vector<double> df(rates.size());
+  switch (freq_type) {
+    case FrequencyTypes::CONTINUOUS:
+      for (size_t i = 0; i < rates.size(); ++i)
+        df[i] = rates[i] * fmax(times[i], gSmall);
+      vecmath::exp_neg(df);
+      break;
+    case FrequencyTypes::SIMPLE:
+      for (size_t i = 0; i < rates.size(); ++i)
+        df[i] = 1.0 / (1.0 + rates[i] * fmax(times[i], gSmall));
+      break;
+    case FrequencyTypes::ANNUAL:
+    case FrequencyTypes::SEMI_ANNUAL:
+    case FrequencyTypes::QUARTERLY:
+    case FrequencyTypes::MONTHLY:
+      /** (1 + r/f)^(-f*t) = exp(-f*t*log(1 + r/f)), both passes batched */
+      for (size_t i = 0; i < rates.size(); ++i)
+        df[i] = 1.0 + rates[i] / f;
+      vecmath::log(df, df);
+      for (size_t i = 0; i < rates.size(); ++i)
+        df[i] *= f * fmax(times[i], gSmall);
+      vecmath::exp_neg(df);
+      break;
+    default:
+      throw std::runtime_error("Unknown frequency");
   }
   return df;
 }
@@ -78,152 +135,283 @@ std::vector<double> DiscountCurve::zero_to_df(const std::vector<double>& rates,
 std::vector<double> DiscountCurve::df_to_zero(const std::vector<double>& dfs,const std::vector<double>& times,
                                FrequencyTypes freq_type) const
 {
-  auto f = static_cast<int>(freq_type);
   if (dfs.size() != times.size())
       throw std::runtime_error("disc facrtors and times have different sizes");
-  auto num_times = times.size();
-  std::vector<double> zero_rates{};
-  zero_rates.reserve(num_times);
-  for (size_t i = 0; i < num_times; ++i){
-      auto t = fmax(times[i],gSmall);
-      if (freq_type == FrequencyTypes::CONTINUOUS){
-        zero_rates.push_back(-log(dfs[i]) / t);
-      } else if (freq_type == FrequencyTypes::SIMPLE){
-        zero_rates.push_back((1.0 / dfs[i] - 1.0) / t);
-      } else {
-        zero_rates.push_back((pow(dfs[i], -1.0 / (t * f)) - 1.0) * f);
-      }
-  }
+  std::vector<double> zero_rates{dfs};
+  dfs_to_zeros(zero_rates, [&](size_t i) { return times[i]; }, freq_type);
   return zero_rates;
 }
 
 std::vector<double> DiscountCurve::df_to_zero(const std::vector<double>& dfs,const std::vector<ChronoDate>& dates,
                               FrequencyTypes freq_type, DayCountTypes day_count_type) const
 {
-  auto f = static_cast<int>(freq_type);
   if (dfs.size() != dates.size())
       throw std::runtime_error("disc facrtors and dates have different sizes");
-  auto num_dates = dates.size();
-  std::vector<double> zero_rates{};
-  zero_rates.reserve(num_dates);
-  for (size_t i = 0; i < num_dates; ++i){
-      auto year_frac = std::get<0>(DayCount(day_count_type).year_frac(valuation_date_,dates[i], FrequencyTypes::ANNUAL));
-      auto t = fmax(year_frac,gSmall);
-      if (freq_type == FrequencyTypes::CONTINUOUS){
-        zero_rates.push_back(-log(dfs[i]) / t);
-      } else if (freq_type == FrequencyTypes::SIMPLE){
-        zero_rates.push_back((1.0 / dfs[i] - 1.0) / t);
-      } else {
-        zero_rates.push_back((pow(dfs[i], -1.0 / (t * f)) - 1.0) * f);
-      }
-  }
+  std::vector<double> zero_rates{dfs};
+  auto day_count = DayCount(day_count_type);
+  dfs_to_zeros(zero_rates, [&](size_t i) {
+    return std::get<0>(day_count.year_frac(valuation_date_, dates[i], FrequencyTypes::ANNUAL));
+  }, freq_type);
   return zero_rates;
 }
 
 double DiscountCurve::df(double time) const{
-  double df{};
-  if (interp_type_ == InterpTypes::FLAT_FWD_RATES ||
-      interp_type_ == InterpTypes::LINEAR_ZERO_RATES ||
-      interp_type_ == InterpTypes::LINEAR_FWD_RATES ||
-      interp_type_ == InterpTypes::FINCUBIC_ZERO_RATES) {
-      df = interpolator_.interpolate(time);
-  } else {
-      throw std::runtime_error("Interpolation type not supposrted");
-  }
-  return df;
+  return interpolator_.interpolate(time);
 }
 
-std::vector<double> DiscountCurve::df(const std::vector<ChronoDate>& dates){
-  std::vector<double> dfv{};
-  dfv.reserve(dates.size());
-  for (size_t i = 0; i < dates.size(); ++i){
-      auto f = df(dates[i]);
-      dfv.push_back(f);
-  }
+UniformLookup DiscountCurve::uniform_lookup(double t_max, std::size_t num_points) const{
+  return UniformLookup::sample(interpolator_, t_max, num_points, times_);
+}
+
+std::vector<double> DiscountCurve::df(const std::vector<ChronoDate>& dates) const{
+  std::vector<double> dfv(dates.size());
+  df(dates, dfv);
   return dfv;
 }
 
+void DiscountCurve::times(std::span<const ChronoDate> dates, std::span<double> out, DayCountTypes day_count_type) const{
+  if (dates.size() != out.size())
+      throw std::runtime_error("Dates and output have different lengths");
+  auto day_count = DayCount(day_count_type);
+  for (size_t i = 0; i < dates.size(); ++i)
+      out[i] = std::get<0>(day_count.year_frac(valuation_date_, dates[i], FrequencyTypes::ANNUAL));
+}
+
+void DiscountCurve::df(std::span<const double> times, std::span<double> out) const{
+  if (times.size() != out.size())
+      throw std::runtime_error("Times and output have different lengths");
+  interpolator_.interpolate(times, out);
+}
+
+void DiscountCurve::df(std::span<const ChronoDate> dates, std::span<double> out) const{
+  /** The times are written to out and interpolated in place */
+  times(dates, out);
+  interpolator_.interpolate(out, out);
+}
+
+double DiscountCurve::year_frac(const ChronoDate& date, DayCountTypes day_count_type) const{
+  return std::get<0>(DayCount(day_count_type).year_frac(valuation_date_,date, FrequencyTypes::ANNUAL));
+}
+
 double DiscountCurve::df(const ChronoDate& date, DayCountTypes day_count_type) const{
-  auto t = std::get<0>(DayCount(day_count_type).year_frac(valuation_date_,date, FrequencyTypes::ANNUAL));
+  if (!df_cache_enabled_)
+    return df(year_frac(date, day_count_type));
+  if (df_cache_valuation_ != valuation_date_.serial_date()) {
+    if (frozen_)
+      return df(year_frac(date, day_count_type));
+    df_cache_.clear();
+    df_cache_valuation_ = valuation_date_.serial_date();
+  }
+  auto key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(date.serial_date())) << 8) |
+             static_cast<std::uint64_t>(day_count_type);
+  auto version = interpolator_.version();
+  auto it = df_cache_.find(key);
+  if (it != df_cache_.end()) {
+    if (it->second.version == version)
+      return it->second.df;
+    auto f = df(it->second.t);
+    if (!frozen_)
+      it->second = CachedDf{it->second.t, f, version};
+    return f;
+  }
+  auto t = year_frac(date, day_count_type);
   auto f = df(t);
+  if (!frozen_)
+    df_cache_.emplace(key, CachedDf{t, f, version});
   return f;
 }
 
+void DiscountCurve::enable_df_cache(bool enable){
+  df_cache_enabled_ = enable;
+  df_cache_.clear();
+  df_cache_valuation_ = valuation_date_.serial_date();
+  frozen_ = false;
+}
+
+void DiscountCurve::freeze(){
+  frozen_ = true;
+}
+
 std::vector<double> DiscountCurve::zero_rates(const std::vector<ChronoDate>& dates, FrequencyTypes freq_type,
-                              DayCountTypes day_count_type){
-  auto dfs = df(dates);
-  auto zeros = df_to_zero(dfs,dates,freq_type,day_count_type);
+                              DayCountTypes day_count_type) const{
+  std::vector<double> zeros(dates.size());
+  zero_rates(dates, zeros, freq_type, day_count_type);
   return zeros;
 }
 
-std::vector<double> DiscountCurve::cc_rates(const std::vector<ChronoDate>& dates,DayCountTypes day_count_type){
+void DiscountCurve::zero_rates(std::span<const ChronoDate> dates, std::span<double> out, FrequencyTypes freq_type,
+                               DayCountTypes day_count_type) const{
+  /** Runs in chunks through a stack buffer of times. With the curve's own ACT_ACT_ISDA
+  day count the dates are converted once and the times serve both the lookup and the
+  rate conversion. */
+  if (dates.size() != out.size())
+      throw std::runtime_error("Dates and output have different lengths");
+  constexpr size_t chunk = 64;
+  std::array<double, chunk> buffer{};
+  for (size_t i0 = 0; i0 < dates.size(); i0 += chunk) {
+    auto len = std::min(chunk, dates.size() - i0);
+    auto ts = std::span(buffer).first(len);
+    auto values = out.subspan(i0, len);
+    times(dates.subspan(i0, len), ts);
+    interpolator_.interpolate(ts, values);
+    if (day_count_type != DayCountTypes::ACT_ACT_ISDA)
+      times(dates.subspan(i0, len), ts, day_count_type);
+    dfs_to_zeros(values, [&](size_t i) { return ts[i]; }, freq_type);
+  }
+}
+
+void DiscountCurve::zero_rates(std::span<const double> times, std::span<double> out, FrequencyTypes freq_type) const{
+  df(times, out);
+  dfs_to_zeros(out, [&](size_t i) { return times[i]; }, freq_type);
+}
+
+std::vector<double> DiscountCurve::cc_rates(const std::vector<ChronoDate>& dates,DayCountTypes day_count_type) const{
   auto zeros = zero_rates(dates,FrequencyTypes::CONTINUOUS,day_count_type);
   return zeros;
 }
 
+void DiscountCurve::cc_rates(std::span<const ChronoDate> dates, std::span<double> out, DayCountTypes day_count_type) const{
+  zero_rates(dates, out, FrequencyTypes::CONTINUOUS, day_count_type);
+}
+
+DiscountCurve::SwapStrip& DiscountCurve::swap_strip(const ChronoDate& effective_date, const ChronoDate& last_date,
+                                                         FrequencyTypes freq_type, DayCountTypes day_count_type){
+  auto& strip = swap_strip_;
+  if (!strip.dates.empty() && strip.effective == effective_date.serial_date() &&
+      strip.last == last_date.serial_date() && strip.valuation == valuation_date_.serial_date() &&
+      strip.freq_type == freq_type && strip.day_count_type == day_count_type)
+    return strip;
+  auto flow_dates = Schedule::create(effective_date, last_date).withFreqType(freq_type).get_schedule();
+  flow_dates[0] = effective_date;
+  strip.dates.assign(flow_dates.begin() + 1, flow_dates.end());
+  strip.alphas.resize(strip.dates.size());
+  strip.times.resize(strip.dates.size());
+  strip.dfs.resize(strip.dates.size());
+  auto day_cc = DayCount(day_count_type);
+  for (size_t i = 0; i < strip.dates.size(); ++i)
+    strip.alphas[i] = std::get<0>(day_cc.year_frac(flow_dates[i], flow_dates[i + 1], FrequencyTypes::ANNUAL));
+  times(strip.dates, strip.times);
+  strip.effective = effective_date.serial_date();
+  strip.last = last_date.serial_date();
+  strip.valuation = valuation_date_.serial_date();
+  strip.freq_type = freq_type;
+  strip.day_count_type = day_count_type;
+  return strip;
+}
+
 std::vector<double> DiscountCurve::swap_rates(const ChronoDate& effective_date, const std::vector<ChronoDate>& maturity_dates,
                               FrequencyTypes freq_type,  DayCountTypes day_count_type){
+  /** Strip mode: one schedule out to the longest maturity, whose dates, accrual factors
+  and times are kept for the next call with the same effective date, and a running
+  PV01 over it. The backward generated schedule of a maturity that sits a whole number
+  of periods before the longest one on the same day of the month is a prefix of the
+  long one, so its par rate is read off the running sums. Days past the 28th are left
+  out since stepping months from them does not always land on the same dates. Any
+  other maturity gets its own schedule as before. */
   if (effective_date < valuation_date_)
       throw std::runtime_error("Swap starts before the curve valuation date");
   if (freq_type == FrequencyTypes::SIMPLE || freq_type == FrequencyTypes::CONTINUOUS)
       throw std::runtime_error("Cannot calculate par rate with continuous or simple freq");
   std::vector<double> par_rates{};
-  for (auto mat_date : maturity_dates){
+  if (maturity_dates.empty())
+      return par_rates;
+  for (const auto& mat_date : maturity_dates)
       if (mat_date <= effective_date)
         throw std::runtime_error("Maturity date is before the swap start date.");
-      auto schedule = Schedule::create(effective_date, mat_date)
-                                              .withFreqType(freq_type);
-      auto flow_dates = schedule.get_schedule();
-      flow_dates[0] = effective_date;
-      auto day_cc = DayCount(day_count_type);
-      auto prev_dt = flow_dates[0];
-      auto pv01 = 0.0;
+  auto last_date = *std::max_element(maturity_dates.begin(), maturity_dates.end());
+  auto& strip = swap_strip(effective_date, last_date, freq_type, day_count_type);
+  auto num_flows = strip.dates.size();
+  interpolator_.interpolate(strip.times, strip.dfs);
+  std::vector<double> pv01s(num_flows);
+  auto pv01 = 0.0;
+  for (size_t i = 0; i < num_flows; ++i) {
+      pv01 += strip.alphas[i] * strip.dfs[i];
+      pv01s[i] = pv01;
+  }
+
+  auto dfStart = df(effective_date);
+  auto period_months = 12 / static_cast<int>(freq_type);
+  par_rates.reserve(maturity_dates.size());
+  for (const auto& mat_date : maturity_dates){
+      auto months_before = (last_date.year() - mat_date.year()) * 12 +
+                           static_cast<int>(last_date.month()) - static_cast<int>(mat_date.month());
       auto discf = 1.0;
-      double par_rate{0.0};
-      for (const auto& next_dt : flow_dates | std::views::drop(1)) {
-        discf = df(next_dt);
-        auto alpha = std::get<0>(day_cc.year_frac(prev_dt, next_dt, FrequencyTypes::ANNUAL));
-        pv01 += alpha * discf;
-        prev_dt = next_dt;
-      }
-      if (abs(pv01) < gSmall) {
-        par_rate = 0.0;
-      }else {
-        auto dfStart = df(effective_date);
-        par_rate = (dfStart - discf) / pv01;
+      if (mat_date.day() == last_date.day() && mat_date.day() <= 28 && months_before % period_months == 0 &&
+          static_cast<size_t>(months_before / period_months) < num_flows) {
+        auto index = num_flows - 1 - static_cast<size_t>(months_before / period_months);
+        pv01 = pv01s[index];
+        discf = strip.dfs[index];
+      } else {
+        auto schedule = Schedule::create(effective_date, mat_date)
+                                                .withFreqType(freq_type);
+        auto flow_dates = schedule.get_schedule();
+        flow_dates[0] = effective_date;
+        auto day_cc = DayCount(day_count_type);
+        auto prev_dt = flow_dates[0];
+        pv01 = 0.0;
+        for (const auto& next_dt : flow_dates | std::views::drop(1)) {
+          discf = df(next_dt);
+          auto alpha = std::get<0>(day_cc.year_frac(prev_dt, next_dt, FrequencyTypes::ANNUAL));
+          pv01 += alpha * discf;
+          prev_dt = next_dt;
+        }
       }
-      par_rates.push_back(par_rate);
+      if (abs(pv01) < gSmall)
+        par_rates.push_back(0.0);
+      else
+        par_rates.push_back((dfStart - discf) / pv01);
   }
   return par_rates;
 }
 
-std::vector<double> DiscountCurve::fwd(const std::vector<ChronoDate>& dates){
-  std::vector<double> fwds{};
-  fwds.reserve(dates.size());
-  auto dt = 1.0 / 365.0;
-  for(auto d : dates){
-      auto df1 = df(d);
-      auto df2 = df(d.add_days(1));
-      auto fwd = log(df1 / df2) / (1.0 * dt);
-      fwds.push_back(fwd);
-  }
+std::vector<double> DiscountCurve::fwd(const std::vector<ChronoDate>& dates) const{
+  std::vector<double> fwds(dates.size());
+  fwd(dates, fwds);
   return fwds;
 }
 
-std::vector<double> DiscountCurve::fwd(const std::vector<double>& times){
-  auto dt = 1e-6;
-  std::vector<double> fwds{};
-  fwds.reserve(times.size());
-  for (auto t : times) {
-      auto tt = fmax(t, dt);
-      auto df1 = df(tt - dt);
-      auto df2 = df(tt + dt);
-      auto fwd = log(df1 / df2) / (2.0 * dt);
-      fwds.push_back(fwd);
-  }
+std::vector<double> DiscountCurve::fwd(const std::vector<double>& times) const{
+  std::vector<double> fwds(times.size());
+  fwd(times, fwds);
   return fwds;
 }
 
+void DiscountCurve::fwd(std::span<const double> times, std::span<double> out) const{
+  /** Instantaneous forwards straight from the interpolant, at a node this is the
+  forward of the segment ending there. */
+  if (times.size() != out.size())
+      throw std::runtime_error("Times and output have different lengths");
+  interpolator_.forward(times, out);
+}
+
+void DiscountCurve::fwd(std::span<const ChronoDate> dates, std::span<double> out) const{
+  times(dates, out);
+  interpolator_.forward(out, out);
+}
+
+std::vector<double> DiscountCurve::df_sensitivities(double time) const{
+  std::vector<double> sens(dfs_.size());
+  interpolator_.node_sensitivities(time, sens);
+  return sens;
+}
+
+void DiscountCurve::df_sensitivities(const ChronoDate& date, std::span<double> out) const{
+  df_sensitivities(year_frac(date, DayCountTypes::ACT_ACT_ISDA), out);
+}
+
+void DiscountCurve::df_sensitivities(double time, std::span<double> out) const{
+  if (out.size() != dfs_.size())
+    throw std::runtime_error("Sensitivities need one entry per node");
+  interpolator_.node_sensitivities(time, out);
+}
+
+std::pair<double, double> DiscountCurve::df_and_last_node_sensitivity(double t) const{
+  auto f = df(t);
+  if (t < SegmentTable::small)
+    return {f, 0.0};
+  return {f, -f * interpolator_.table().last_exponent_gradient(t)};
+}
+
 double DiscountCurve::fwd_rate(const ChronoDate& start_date, const ChronoDate& date, DayCountTypes day_count_type){
   auto yf = std::get<0>(DayCount(day_count_type).year_frac(start_date,date,FrequencyTypes::ANNUAL));
   auto df1 = df(start_date);
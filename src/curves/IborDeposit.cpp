@@ -48,6 +48,16 @@ double IborDeposit::value(const ChronoDate& val_date, const DiscountCurve& libor
   return v;
 }
 
+CashflowPlan IborDeposit::cashflow_plan(const ChronoDate& val_date, const DiscountCurve& curve) const{
+  if (val_date > start_date_)
+    throw std::runtime_error("Start date after maturity date");
+  ChronoDate dates[2]{start_date_, maturity_date_};
+  double times[2]{};
+  curve.times(dates, times);
+  auto acc_factor = std::get<0>(DayCount(day_count_type_).year_frac(start_date_, maturity_date_, FrequencyTypes::ANNUAL));
+  return {times[0], {{.pay_time = times[1], .amount = (1.0 + acc_factor * deposit_rate_) * notional_}}};
+}
+
 double IborDeposit::maturity_df() const{
   DayCount dc = DayCount{day_count_type_};
   auto acc_factor = std::get<0>(dc.year_frac(start_date_, maturity_date_, FrequencyTypes::ANNUAL));
@@ -55,9 +65,22 @@ double IborDeposit::maturity_df() const{
   return df;
 }
 
+double IborDeposit::maturity_df_rate_sensitivity() const{
+  auto acc_factor = std::get<0>(DayCount(day_count_type_).year_frac(start_date_, maturity_date_, FrequencyTypes::ANNUAL));
+  auto df = maturity_df();
+  return -acc_factor * df * df;
+}
+
+double IborDeposit::quote_sensitivity(const ChronoDate&, const DiscountCurve& curve) const{
+  auto acc_factor = std::get<0>(DayCount(day_count_type_).year_frac(start_date_, maturity_date_, FrequencyTypes::ANNUAL));
+  return acc_factor * curve.df(maturity_date_) / curve.df(start_date_);
+}
+
 ChronoDate IborDeposit::get_start_date() const{ return start_date_;}
 ChronoDate IborDeposit::get_maturity_date() const{ return maturity_date_;}
 double IborDeposit::get_notional() const {return notional_;}
+double IborDeposit::get_deposit_rate() const {return deposit_rate_;}
 
 void IborDeposit::set_start_date(ChronoDate dt){start_date_ = dt;}
-void IborDeposit::set_maturity_date(ChronoDate dt){maturity_date_ = dt;}
\ No newline at end of file
+void IborDeposit::set_maturity_date(ChronoDate dt){maturity_date_ = dt;}
+void IborDeposit::set_deposit_rate(double rate){deposit_rate_ = rate;}
\ No newline at end of file
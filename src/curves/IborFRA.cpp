@@ -54,6 +54,16 @@ double IborFRA::value(const ChronoDate& val_date, const DiscountCurve& disc_curv
   return v;
 }
 
+CashflowPlan IborFRA::cashflow_plan(const ChronoDate& val_date, const DiscountCurve& curve) const{
+  ChronoDate dates[3]{val_date, start_date_, maturity_date_};
+  double times[3]{};
+  curve.times(dates, times);
+  auto acc_factor = std::get<0>(DayCount(day_count_type_).year_frac(start_date_, maturity_date_,FrequencyTypes::ANNUAL));
+  auto accrual = (pay_fixed_rate_ ? -1.0 : 1.0) * acc_factor * notional_;
+  return {times[0], {{.pay_time = times[2], .amount = -accrual * fra_rate_, .weight = accrual,
+                      .start_time = times[1], .end_time = times[2], .alpha = acc_factor}}};
+}
+
 double IborFRA::maturity_df(const DiscountCurve& index_curve) const {
   DayCount dc = DayCount(day_count_type_);
   auto df1 = index_curve.df(start_date_);
@@ -62,6 +72,20 @@ double IborFRA::maturity_df(const DiscountCurve& index_curve) const {
   return df2;
 }
 
+double IborFRA::maturity_df_rate_sensitivity(const DiscountCurve& index_curve) const{
+  auto acc_factor = std::get<0>(DayCount(day_count_type_).year_frac(start_date_, maturity_date_, FrequencyTypes::ANNUAL));
+  auto growth = 1.0 + acc_factor * fra_rate_;
+  return -acc_factor * index_curve.df(start_date_) / (growth * growth);
+}
+
+double IborFRA::quote_sensitivity(const ChronoDate& val_date, const DiscountCurve& curve) const{
+  auto acc_factor = std::get<0>(DayCount(day_count_type_).year_frac(start_date_, maturity_date_,FrequencyTypes::ANNUAL));
+  auto sensitivity = -acc_factor * curve.df(maturity_date_) / curve.df(val_date);
+  return pay_fixed_rate_ ? -sensitivity : sensitivity;
+}
+
 ChronoDate IborFRA::get_start_date() const { return start_date_;}
 ChronoDate IborFRA::get_maturity_date() const { return maturity_date_;}
-double IborFRA::get_notional() const { return notional_;}
\ No newline at end of file
+double IborFRA::get_notional() const { return notional_;}
+double IborFRA::get_fra_rate() const { return fra_rate_;}
+void IborFRA::set_fra_rate(double rate){ fra_rate_ = rate;}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include <boost/math/tools/roots.hpp>
 #include <boost/math/tools/toms748_solve.hpp>
+#include <Eigen/SparseLU>
+#include <algorithm>
 #include <cmath>
 #include <finproj/curves/IborSingleCurve.h>
 #include <ranges>
@@ -7,17 +9,25 @@
 IborSingleCurve::IborSingleCurve ( const ChronoDate& val_date, const std::vector<IborDeposit>& ibor_deposits,
                 const std::vector<IborFRA>& ibor_fras, const std::vector<IborSwap>& ibor_swaps,
                 InterpTypes interp_type,
-                bool check_refit):
+                bool check_refit,
+                BootstrapTypes bootstrap_type):
                DiscountCurve(val_date,FrequencyTypes::ANNUAL,DayCountTypes::ACT_360,interp_type),
                                                      ibor_deposits_{ibor_deposits},
                                                      ibor_fras_{ibor_fras},
-                                                     ibor_swaps_{ibor_swaps}, check_refit_{check_refit}
+                                                     ibor_swaps_{ibor_swaps}, check_refit_{check_refit},
+                                                     bootstrap_type_{bootstrap_type}
 {
   validate_inputs();
   build_curve();
 }
+
+IborSingleCurve::IborSingleCurve(const CurveView& view):DiscountCurve(view){}
 void IborSingleCurve::build_curve(){
   build_curve_using_1d_solver();
+  if (bootstrap_type_ == BootstrapTypes::GLOBAL)
+    build_curve_using_global_solver();
+  if (check_refit_)
+    check_refits(1e-10,1e-10,1e-5);
 }
 void IborSingleCurve::validate_inputs(){
 
@@ -128,6 +138,7 @@ void IborSingleCurve::validate_inputs(){
         synthetic_deposit.set_start_date(valuation_date_);
         synthetic_deposit.set_maturity_date(first_depo.get_start_date());
         ibor_deposits_.insert(ibor_deposits_.begin(), synthetic_deposit);
+        synthetic_deposit_ = true;
       }
     }
   }
@@ -141,83 +152,405 @@ void IborSingleCurve::validate_inputs(){
 
 
 
-void IborSingleCurve::build_curve_using_1d_solver() {
-  double tmat = 0.0, df_mat = 1.0;
-  times_.push_back(tmat);
-  dfs_.push_back(df_mat);
-  interpolator_.fit(times_,dfs_);
-
-  for (auto &dep: ibor_deposits_) {
-    auto df_settle = df(dep.get_start_date());
-    df_mat = dep.maturity_df() * df_settle;
-    tmat = double(dep.get_maturity_date() - valuation_date_) / 365.0;
-    times_.push_back(tmat);
-    dfs_.push_back(df_mat);
-    interpolator_.fit(times_,dfs_);
+void IborSingleCurve::set_last_node(double df){
+  dfs_.back() = df;
+  interpolator_.set_last_value(df);
+}
+
+template <class ValueAndDerivative>
+bool IborSingleCurve::solve_last_node_newton(ValueAndDerivative&& value_and_derivative, double guess){
+  /** Steps of 1e-10 relative leave an error far below double precision once the
+  convergence is quadratic */
+  const int max_iterations = 20;
+  const double tolerance = 1e-10;
+  auto df = guess;
+  for (int i{0}; i < max_iterations; ++i) {
+    auto [v, dv] = value_and_derivative(df);
+    if (!std::isfinite(v) || !std::isfinite(dv) || dv == 0.0)
+      return false;
+    auto step = v / dv;
+    if (!(df - step > 0.0))
+      return false;
+    df -= step;
+    if (std::fabs(step) <= tolerance * df) {
+      set_last_node(df);
+      return true;
+    }
   }
+  return false;
+}
+
+void IborSingleCurve::build_curve_using_1d_solver() {
+  solver_evaluations_ = 0;
+  auto num_nodes = 1 + ibor_deposits_.size() + ibor_fras_.size() + ibor_swaps_.size();
+  times_.reserve(num_nodes);
+  dfs_.reserve(num_nodes);
+  interpolator_.reserve(num_nodes);
+  times_.push_back(0.0);
+  dfs_.push_back(1.0);
+  interpolator_.push_node(0.0, 1.0);
+  fras_from_start_df_.assign(ibor_fras_.size(), false);
+  plans_.clear();
+  for (size_t i{0}; i < ibor_deposits_.size() + ibor_fras_.size() + ibor_swaps_.size(); ++i)
+    plans_.push_back(instrument_plan(i));
+  solve_nodes_from(0, {});
+}
 
-  auto old_tmat = tmat;
+void IborSingleCurve::solve_nodes_from(std::size_t first, std::span<const double> seeds) {
+  auto newton = interp_type_ == InterpTypes::FLAT_FWD_RATES || interp_type_ == InterpTypes::LINEAR_ZERO_RATES;
+  auto num_deposits = ibor_deposits_.size();
+  auto num_fras = ibor_fras_.size();
+  auto num_instruments = num_deposits + num_fras + ibor_swaps_.size();
+  /** A seed is the node before a tick and the root is close by, so the bracket is
+  first widened in steps of 1% rather than doubled. */
+  const double seeded_factor = 1.01;
 
-  for (auto &fra: ibor_fras_) {
-    auto tset = double(fra.get_start_date() - valuation_date_) / 365.0;
-    tmat = double(fra.get_maturity_date() - valuation_date_) / 365.0;
-    if (tset < old_tmat && tmat > old_tmat) {
-      df_mat = fra.maturity_df(*this);
+  for (auto i = first; i < num_instruments; ++i) {
+    auto df_mat = dfs_.back();
+    auto seeded = i - first < seeds.size();
+    if (i < num_deposits) {
+      auto& dep = ibor_deposits_[i];
+      auto df_settle = df(dep.get_start_date());
+      df_mat = dep.maturity_df() * df_settle;
+      auto tmat = double(dep.get_maturity_date() - valuation_date_) / 365.0;
       times_.push_back(tmat);
       dfs_.push_back(df_mat);
-    } else {
+      interpolator_.push_node(tmat, df_mat);
+      continue;
+    }
+
+    if (i < num_deposits + num_fras) {
+      auto j = i - num_deposits;
+      auto& fra = ibor_fras_[j];
+      auto old_tmat = times_[num_deposits];
+      auto tset = double(fra.get_start_date() - valuation_date_) / 365.0;
+      auto tmat = double(fra.get_maturity_date() - valuation_date_) / 365.0;
+      fras_from_start_df_[j] = tset < old_tmat && tmat > old_tmat;
+      if (fras_from_start_df_[j]) {
+        df_mat = fra.maturity_df(*this);
+        times_.push_back(tmat);
+        dfs_.push_back(df_mat);
+        interpolator_.push_node(tmat, df_mat);
+        continue;
+      }
+      auto guess = seeded ? seeds[i - first] : newton ? df(tmat) : df_mat;
       times_.push_back(tmat);
-      dfs_.push_back(df_mat);
+      dfs_.push_back(guess);
+      interpolator_.push_node(tmat, guess);
+      auto fra_value = [&](double df) {
+        set_last_node(df);
+        ++solver_evaluations_;
+        return plans_[i].value_and_last_node_sensitivity(*this);
+      };
+      if (newton && solve_last_node_newton(fra_value, guess))
+        continue;
       auto _g = [&](const double df) {
         (*this).dfs_.back() = df;
-        (*this).interpolator_.fit(times_, dfs_);
-        auto v_fra = fra.value(valuation_date_, *this, *this);
-        v_fra /= fra.get_notional();
-        return v_fra;
+        (*this).interpolator_.set_last_value(df);
+        ++solver_evaluations_;
+        return plans_[i].pv(*this);
       };
       int digits = std::numeric_limits<double>::digits;
-      int get_digits = (digits * 3) /4;
+      int get_digits = digits - 8;
       boost::math::tools::eps_tolerance<double> tol(get_digits);
       const boost::uintmax_t maxit = 50;
       boost::uintmax_t it = maxit;
-      auto ret = boost::math::tools::bracket_and_solve_root(_g, df_mat, 2.0, df_mat > 1.0 ? true:false, tol, it);
+      auto start = seeded ? guess : df_mat;
+      auto ret = boost::math::tools::bracket_and_solve_root(_g, start, seeded ? seeded_factor : 2.0,
+                                                             start > 1.0 ? true:false, tol, it);
       //std::cout << "x at minimum = " << ret.first << ", f(" << ret.first << ") = " << ret.second << std::endl;
-      df_mat = ret.first;
+      set_last_node(ret.first);
       //Iteration *secant1 = new Secant(1e-10, _g);
       //df_mat = secant1->solve(1e-3, 2);
-
+      continue;
     }
-  }
 
-  for (auto &swap: ibor_swaps_) {
+    auto& swap = ibor_swaps_[i - num_deposits - num_fras];
     auto maturity_date = swap.get_fixed_leg().generate_payment_dates().back();
-    tmat = double(maturity_date - valuation_date_) / 365.0;
+    auto tmat = double(maturity_date - valuation_date_) / 365.0;
+    auto guess = seeded ? seeds[i - first] : newton ? df(tmat) : df_mat;
     times_.push_back(tmat);
-    dfs_.push_back(df_mat);
+    dfs_.push_back(guess);
+    interpolator_.push_node(tmat, guess);
 
+    /** Under the local schemes the payments up to the previous node do not move with
+    this one, so Newton revalues only those after it */
+    const auto& plan = plans_[i];
+    auto first_moving = newton ? plan.first_after(times_[times_.size() - 2]) : 0;
+    auto head = plan.head_value(*this, first_moving);
+    auto swap_value = [&](double df) {
+      set_last_node(df);
+      ++solver_evaluations_;
+      return plan.value_and_last_node_sensitivity(*this, first_moving, head);
+    };
+    if (newton && solve_last_node_newton(swap_value, guess))
+      continue;
     auto _f = [&](double df)  {
       (*this).dfs_.back() = df;
-      (*this).interpolator_.fit(times_, dfs_);
-      std::optional<DiscountCurve> idx_optional = std::nullopt;
-      std::optional<double> ffr_optional = std::nullopt;
-      auto v_swap = swap.value(valuation_date_, *this, idx_optional, ffr_optional);
-      v_swap /= swap.get_fixed_leg().get_notional();
-      return v_swap;
+      (*this).interpolator_.set_last_value(df);
+      ++solver_evaluations_;
+      return plan.pv(*this);
     };
     int digits = std::numeric_limits<double>::digits;
-    int get_digits = (digits * 3) /4;
+    int get_digits = digits - 8;
     boost::math::tools::eps_tolerance<double> tol(get_digits);
     const boost::uintmax_t maxit = 50;
     boost::uintmax_t it = maxit;
-    auto ret = boost::math::tools::bracket_and_solve_root(_f, df_mat, 2.0, false, tol, it);
+    auto ret = boost::math::tools::bracket_and_solve_root(_f, seeded ? guess : df_mat, seeded ? seeded_factor : 2.0,
+                                                           false, tol, it);
     //Iteration *secant1 = new Secant(1e-10, _f);
     //df_mat = secant1->solve(1e-3, 2);
-    df_mat = ret.first;
+    set_last_node(ret.first);
+  }
+}
+
+void IborSingleCurve::update_quotes(std::span<const double> new_quotes){
+  auto num_deposits = ibor_deposits_.size();
+  auto num_fras = ibor_fras_.size();
+  auto num_instruments = num_deposits + num_fras + ibor_swaps_.size();
+  size_t synthetic = synthetic_deposit_ ? 1 : 0;
+  if (new_quotes.size() != num_instruments - synthetic)
+    throw std::runtime_error("Expected one quote per calibration instrument");
+  if (dfs_.size() != num_instruments + 1)
+    throw std::runtime_error("Quotes can only be updated on a curve built from its instruments");
+  auto old_quotes = quotes();
+  auto first = num_instruments;
+  for (size_t i{synthetic}; i < num_instruments; ++i) {
+    auto quote = new_quotes[i - synthetic];
+    if (quote == old_quotes[i - synthetic])
+      continue;
+    first = std::min(first, i);
+    if (i < num_deposits)
+      ibor_deposits_[i].set_deposit_rate(quote);
+    else if (i < num_deposits + num_fras)
+      ibor_fras_[i - num_deposits].set_fra_rate(quote);
+    else
+      ibor_swaps_[i - num_deposits - num_fras].set_fixed_coupon(quote);
+    plans_[i] = instrument_plan(i);
+    if (synthetic_deposit_ && i == 1) {
+      /** the synthetic deposit in front copies the first deposit's rate */
+      ibor_deposits_[0].set_deposit_rate(quote);
+      plans_[0] = instrument_plan(0);
+      first = 0;
+    }
+  }
+  solver_evaluations_ = 0;
+  if (first == num_instruments)
+    return;
+
+  if (bootstrap_type_ == BootstrapTypes::GLOBAL) {
+    build_curve_using_global_solver();
+  } else {
+    /** the previous nodes seed the searches of the nodes they are replaced by */
+    std::vector<double> seeds(dfs_.begin() + static_cast<std::ptrdiff_t>(first) + 1, dfs_.end());
+    while (dfs_.size() > first + 1) {
+      times_.pop_back();
+      dfs_.pop_back();
+      interpolator_.pop_node();
+    }
+    solve_nodes_from(first, seeds);
   }
   if (check_refit_)
     check_refits(1e-10,1e-10,1e-5);
 }
 
+std::vector<double> IborSingleCurve::quotes() const{
+  std::vector<double> quotes{};
+  quotes.reserve(ibor_deposits_.size() + ibor_fras_.size() + ibor_swaps_.size());
+  for (size_t i{synthetic_deposit_ ? 1u : 0u}; i < ibor_deposits_.size(); ++i)
+    quotes.push_back(ibor_deposits_[i].get_deposit_rate());
+  for (auto& fra : ibor_fras_)
+    quotes.push_back(fra.get_fra_rate());
+  for (auto& swap : ibor_swaps_)
+    quotes.push_back(swap.get_fixed_coupon());
+  return quotes;
+}
+
+void IborSingleCurve::build_curve_using_global_solver(){
+  auto num_nodes = dfs_.size();
+  auto num_unknowns = static_cast<Eigen::Index>(num_nodes - 1);
+  if (num_nodes - 1 != ibor_deposits_.size() + ibor_fras_.size() + ibor_swaps_.size())
+    throw std::runtime_error("Global solve needs one node per instrument, build the curve first");
+  /** Residuals and Jacobian at the current nodes, one row per instrument. The origin
+  node is fixed at one and has no column. */
+  std::vector<double> grad(num_nodes), work(num_nodes);
+  std::vector<Eigen::Triplet<double>> triplets{};
+  Eigen::VectorXd residuals(num_unknowns);
+  auto evaluate = [&] {
+    triplets.clear();
+    for (Eigen::Index row{0}; row < num_unknowns; ++row) {
+      residuals(row) = instrument_residual(static_cast<size_t>(row), *this, grad, work);
+      for (size_t j{1}; j < num_nodes; ++j)
+        if (grad[j] != 0.0)
+          triplets.emplace_back(row, static_cast<Eigen::Index>(j - 1), grad[j]);
+    }
+    jacobian_.resize(num_unknowns, num_unknowns);
+    jacobian_.setFromTriplets(triplets.begin(), triplets.end());
+  };
+
+  const int max_iterations = 20;
+  const double tolerance = 1e-12;
+  Eigen::SparseLU<Eigen::SparseMatrix<double>> solver{};
+  for (global_iterations_ = 1; global_iterations_ <= max_iterations; ++global_iterations_) {
+    evaluate();
+    solver.compute(jacobian_);
+    if (solver.info() != Eigen::Success)
+      throw std::runtime_error("Bootstrap Jacobian is singular");
+    Eigen::VectorXd step = solver.solve(residuals);
+    auto converged = true;
+    for (Eigen::Index j{0}; j < num_unknowns; ++j) {
+      auto& df = dfs_[static_cast<size_t>(j) + 1];
+      df -= step(j);
+      if (!(df > 0.0))
+        throw std::runtime_error("Global bootstrap left the positive discount factors");
+      converged = converged && std::fabs(step(j)) <= tolerance * df;
+    }
+    interpolator_.fit(times_, dfs_);
+    if (converged) {
+      // the Jacobian at the solution, for reuse by callers
+      evaluate();
+      return;
+    }
+  }
+  throw std::runtime_error("Global bootstrap did not converge");
+}
+
+CashflowPlan IborSingleCurve::instrument_plan(std::size_t i) const{
+  CashflowPlan plan{};
+  double notional{};
+  if (i < ibor_deposits_.size()) {
+    plan = ibor_deposits_[i].cashflow_plan(valuation_date_, *this);
+    notional = ibor_deposits_[i].get_notional();
+  } else if (i - ibor_deposits_.size() < ibor_fras_.size()) {
+    const auto& fra = ibor_fras_[i - ibor_deposits_.size()];
+    plan = fra.cashflow_plan(valuation_date_, *this);
+    notional = fra.get_notional();
+  } else {
+    const auto& swap = ibor_swaps_[i - ibor_deposits_.size() - ibor_fras_.size()];
+    plan = swap.cashflow_plan(valuation_date_, *this);
+    notional = swap.get_notional();
+  }
+  plan.scale(1.0 / notional);
+  return plan;
+}
+
+double IborSingleCurve::instrument_residual(std::size_t i, const DiscountCurve& curve, std::span<double> grad,
+                                            std::span<double> work) const{
+  auto v = plans_[i].value_and_node_sensitivities(curve, grad, work);
+  return i < ibor_deposits_.size() ? v - 1.0 : v;
+}
+
+double IborSingleCurve::instrument_quote_sensitivity(std::size_t i, const DiscountCurve& curve) const{
+  if (i < ibor_deposits_.size())
+    return ibor_deposits_[i].quote_sensitivity(valuation_date_, curve);
+  i -= ibor_deposits_.size();
+  if (i < ibor_fras_.size())
+    return ibor_fras_[i].quote_sensitivity(valuation_date_, curve);
+  return ibor_swaps_[i - ibor_fras_.size()].quote_sensitivity(valuation_date_, curve);
+}
+
+std::pair<Eigen::SparseMatrix<double>, Eigen::VectorXd> IborSingleCurve::node_and_quote_jacobians() const{
+  auto num_instruments = ibor_deposits_.size() + ibor_fras_.size() + ibor_swaps_.size();
+  if (num_instruments == 0 || dfs_.size() != num_instruments + 1)
+    throw std::runtime_error("Quote sensitivities need a curve built from its instruments");
+  auto n = static_cast<Eigen::Index>(num_instruments);
+  Eigen::VectorXd quote_sensitivities(n);
+  if (bootstrap_type_ == BootstrapTypes::GLOBAL) {
+    for (size_t i{0}; i < num_instruments; ++i)
+      quote_sensitivities(static_cast<Eigen::Index>(i)) = instrument_quote_sensitivity(i, *this);
+    return {jacobian_, quote_sensitivities};
+  }
+  /** Instrument i fixed node i + 1 on the curve of the nodes up to it, so it is
+  evaluated on that curve, peeling the nodes off a copy from the back. */
+  IborSingleCurve partial{*this};
+  std::vector<double> grad(dfs_.size()), work(dfs_.size());
+  std::vector<Eigen::Triplet<double>> triplets{};
+  for (auto i = num_instruments; i-- > 0;) {
+    auto row = static_cast<Eigen::Index>(i);
+    auto fra = i - ibor_deposits_.size();
+    if (i < ibor_deposits_.size() || (fra < ibor_fras_.size() && fras_from_start_df_[fra])) {
+      /** The build set these nodes to the start df on the curve in front of them times
+      the instrument's growth factor, so the equation is node - that product = 0 */
+      partial.times_.pop_back();
+      partial.dfs_.pop_back();
+      partial.interpolator_.pop_node();
+      ChronoDate start_date{};
+      double growth_df{}, d_growth_df{};
+      if (i < ibor_deposits_.size()) {
+        start_date = ibor_deposits_[i].get_start_date();
+        growth_df = ibor_deposits_[i].maturity_df();
+        d_growth_df = ibor_deposits_[i].maturity_df_rate_sensitivity();
+      } else {
+        start_date = ibor_fras_[fra].get_start_date();
+        growth_df = ibor_fras_[fra].maturity_df(partial) / partial.df(start_date);
+        d_growth_df = ibor_fras_[fra].maturity_df_rate_sensitivity(partial) / partial.df(start_date);
+      }
+      partial.df_sensitivities(start_date, std::span<double>{grad}.first(i + 1));
+      triplets.emplace_back(row, row, 1.0);
+      for (size_t j{1}; j < i + 1; ++j)
+        if (grad[j] != 0.0)
+          triplets.emplace_back(row, static_cast<Eigen::Index>(j - 1), -growth_df * grad[j]);
+      quote_sensitivities(row) = -partial.df(start_date) * d_growth_df;
+      continue;
+    }
+    instrument_residual(i, partial, std::span<double>{grad}.first(i + 2), std::span<double>{work}.first(i + 2));
+    quote_sensitivities(row) = instrument_quote_sensitivity(i, partial);
+    for (size_t j{1}; j < i + 2; ++j)
+      if (grad[j] != 0.0)
+        triplets.emplace_back(row, static_cast<Eigen::Index>(j - 1), grad[j]);
+    partial.times_.pop_back();
+    partial.dfs_.pop_back();
+    partial.interpolator_.pop_node();
+  }
+  Eigen::SparseMatrix<double> jacobian(n, n);
+  jacobian.setFromTriplets(triplets.begin(), triplets.end());
+  return {jacobian, quote_sensitivities};
+}
+
+Eigen::MatrixXd IborSingleCurve::quote_jacobian() const{
+  auto [jacobian, quote_sensitivities] = node_and_quote_jacobians();
+  jacobian.makeCompressed();
+  Eigen::SparseLU<Eigen::SparseMatrix<double>> solver{};
+  solver.compute(jacobian);
+  if (solver.info() != Eigen::Success)
+    throw std::runtime_error("Bootstrap Jacobian is singular");
+  Eigen::MatrixXd rhs = -Eigen::MatrixXd(quote_sensitivities.asDiagonal());
+  Eigen::MatrixXd node_jacobian = solver.solve(rhs);
+  if (!synthetic_deposit_)
+    return node_jacobian;
+  /** the synthetic deposit moves with the first deposit's rate */
+  node_jacobian.col(1) += node_jacobian.col(0);
+  return node_jacobian.rightCols(node_jacobian.cols() - 1);
+}
+
+std::vector<double> IborSingleCurve::bucketed_dv01(std::span<const IborSwap> portfolio) const{
+  auto [jacobian, quote_sensitivities] = node_and_quote_jacobians();
+  /** d value / d q = g^T dx/dq = -(J^-T g) * dV/dq, so one solve with the transpose
+  serves all quotes. */
+  std::vector<double> grad(dfs_.size()), work(dfs_.size());
+  Eigen::VectorXd node_sensitivities = Eigen::VectorXd::Zero(jacobian.cols());
+  for (const auto& swap : portfolio) {
+    swap.cashflow_plan(valuation_date_, *this).value_and_node_sensitivities(*this, grad, work);
+    for (Eigen::Index j{0}; j < node_sensitivities.size(); ++j)
+      node_sensitivities(j) += grad[static_cast<size_t>(j) + 1];
+  }
+  Eigen::SparseMatrix<double> transposed = jacobian.transpose();
+  Eigen::SparseLU<Eigen::SparseMatrix<double>> solver{};
+  solver.compute(transposed);
+  if (solver.info() != Eigen::Success)
+    throw std::runtime_error("Bootstrap Jacobian is singular");
+  Eigen::VectorXd adjoint = solver.solve(node_sensitivities);
+  const double one_bp = 1e-4;
+  std::vector<double> dv01(static_cast<size_t>(adjoint.size()));
+  for (Eigen::Index k{0}; k < adjoint.size(); ++k)
+    dv01[static_cast<size_t>(k)] = -adjoint(k) * quote_sensitivities(k) * one_bp;
+  if (synthetic_deposit_) {
+    dv01[1] += dv01[0];
+    dv01.erase(dv01.begin());
+  }
+  return dv01;
+}
+
 void IborSingleCurve::check_refits(double depo_tol, double fra_tol, double swap_tol){
   for (auto& dep : ibor_deposits_){
     auto v = dep.value(valuation_date_, (*this))/dep.get_notional();
@@ -231,8 +564,8 @@ void IborSingleCurve::check_refits(double depo_tol, double fra_tol, double swap_
     }
   }
   for (auto& swap : ibor_swaps_){
-    auto v = swap.value(valuation_date_,(*this),(*this), std::optional<double>{});
-    v = v / swap.get_fixed_leg().get_notional();
+    auto v = swap.pv(valuation_date_, *this);
+    v = v / swap.get_notional();
     if (fabs(v) > swap_tol){
       throw std::runtime_error("Swap not repriced");
     }
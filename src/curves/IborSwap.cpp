@@ -1,6 +1,7 @@
 #include <finproj/curves/IborSwap.h>
 #include <finproj/utils/Misc.h>
 #include <cmath>
+#include <utility>
 
 IborSwap::IborSwap(const ChronoDate& eff_date, const ChronoDate& termination_date,
                    SwapTypes fixed_leg_type,double fixed_coupon,FrequencyTypes fixed_freq_type,
@@ -52,21 +53,36 @@ IborSwap::IborSwap(const ChronoDate& eff_date, std::string&& tenor,
 
 double IborSwap::value(const ChronoDate& val_date, const DiscountCurve& disc_curve,std::optional<DiscountCurve> index_curve,
             std::optional<double> first_fixing_rate){
+  return pv(val_date, disc_curve, index_curve.has_value() ? index_curve.value() : disc_curve, first_fixing_rate);
+}
+
+double IborSwap::pv(const ChronoDate& val_date, const DiscountCurve& disc_curve, const DiscountCurve& index_curve,
+                    std::optional<double> first_fixing_rate) const{
+  return fixed_leg_.pv(val_date, disc_curve) + double_leg_.pv(val_date, disc_curve, index_curve, first_fixing_rate);
+}
 
-  DiscountCurve idx_curve{};
-  if (!index_curve.has_value())
-    idx_curve = disc_curve;
-  else idx_curve = index_curve.value();
+double IborSwap::pv(const ChronoDate& val_date, const DiscountCurve& curve) const{
+  return pv(val_date, curve, curve);
+}
 
-  auto fixed_leg_value = fixed_leg_.value(val_date,disc_curve);
-  auto double_leg_value = double_leg_.value(val_date,disc_curve,idx_curve,first_fixing_rate);
-  auto value = fixed_leg_value + double_leg_value;
-  return value;
+CashflowPlan IborSwap::cashflow_plan(const ChronoDate& val_date, const DiscountCurve& curve,
+                                     std::optional<double> first_fixing_rate) const{
+  std::vector<PlannedCashflow> cashflows{};
+  fixed_leg_.append_cashflows(val_date, curve, cashflows);
+  double_leg_.append_cashflows(val_date, curve, first_fixing_rate, cashflows);
+  double anchor_time{};
+  curve.times(std::span{&val_date, 1}, std::span{&anchor_time, 1});
+  return {anchor_time, std::move(cashflows)};
+}
+
+double IborSwap::quote_sensitivity(const ChronoDate& val_date, const DiscountCurve& curve) const{
+  auto annuity = fixed_leg_.annuity(val_date, curve) / fixed_leg_.get_notional();
+  return fixed_leg_type_ == SwapTypes::PAY ? -annuity : annuity;
 }
 
 double IborSwap::pv01(const ChronoDate& val_date,const DiscountCurve& disc_curve)  {
   /** Calculate the value of 1 basis point coupon on the fixed leg.*/
-  auto pv = fixed_leg_.value(val_date, disc_curve);
+  auto pv = fixed_leg_.pv(val_date, disc_curve);
   auto pv01 = pv / fixed_leg_.get_coupon() / fixed_leg_.get_notional();
   //Needs to be positive even if it is a payer leg
   pv01 = fabs(pv01);
@@ -101,6 +117,12 @@ double IborSwap::swap_rate(const ChronoDate& val_date, const DiscountCurve& disc
 
 ChronoDate IborSwap::get_eff_date() const { return eff_date_;}
 ChronoDate IborSwap::get_maturity_date() const { return maturity_date_;}
+double IborSwap::get_notional() const { return notional_;}
+double IborSwap::get_fixed_coupon() const { return fixed_coupon_;}
+void IborSwap::set_fixed_coupon(double coupon){
+  fixed_coupon_ = coupon;
+  fixed_leg_.set_coupon(coupon);
+}
 SwapFixedLeg IborSwap::get_fixed_leg() const { return fixed_leg_;}
 SwapFloatLeg IborSwap::get_double_leg() const {return double_leg_;}
 ChronoDate IborSwap::get_termination_date() const { return termination_date_;}
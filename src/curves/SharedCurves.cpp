@@ -0,0 +1,134 @@
+#include <finproj/curves/SharedCurves.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char magic[8] = {'F', 'P', 'C', 'S', 'H', 'M', '0', '1'};
+
+static_assert(sizeof(shared_curves::Control) <= shared_curves::slot_offset);
+
+/** Slots start 64 byte aligned, which keeps the image arrays 8 byte aligned. */
+std::size_t slot_stride(std::uint64_t capacity){
+  return static_cast<std::size_t>((capacity + 63) / 64 * 64);
+}
+
+std::size_t object_size(std::uint64_t capacity){
+  return shared_curves::slot_offset + 2 * slot_stride(capacity);
+}
+
+}// namespace
+
+SharedCurvePublisher::SharedCurvePublisher(const std::string& name, std::size_t capacity){
+  if (capacity == 0)
+    throw std::runtime_error("Shared curve capacity must be positive");
+  ::shm_unlink(name.c_str());
+  auto fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0)
+    throw std::runtime_error("Cannot create shared curves " + name);
+  size_ = object_size(capacity);
+  if (::ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    throw std::runtime_error("Cannot size shared curves " + name);
+  }
+  auto* mapping = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    ::shm_unlink(name.c_str());
+    throw std::runtime_error("Cannot map shared curves " + name);
+  }
+  data_ = static_cast<std::byte*>(mapping);
+  // the counters are constructed before the magic, so a reader that sees the magic
+  // also sees a valid control block
+  control_ = new (data_) shared_curves::Control{};
+  control_->format_version = shared_curves::format_version;
+  control_->capacity = capacity;
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(control_->magic, magic, sizeof magic);
+}
+
+SharedCurvePublisher::~SharedCurvePublisher(){
+  ::munmap(data_, size_);
+}
+
+std::uint64_t SharedCurvePublisher::publish(const CurveSnapshotWriter& writer){
+  auto image = writer.bytes();
+  if (image.size() > control_->capacity)
+    throw std::runtime_error("Curve snapshot of " + std::to_string(image.size()) +
+                             " bytes exceeds the shared capacity of " + std::to_string(control_->capacity));
+  auto next = control_->generation.load(std::memory_order_relaxed) + 1;
+  auto slot = next % 2;
+  /** Announce the overwrite before touching the slot: readers of generation next - 2
+  check writing after they are done and retry. */
+  control_->writing.store(next, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(data_ + shared_curves::slot_offset + slot * slot_stride(control_->capacity), image.data(), image.size());
+  control_->length[slot].store(image.size(), std::memory_order_relaxed);
+  control_->generation.store(next, std::memory_order_release);
+  return next;
+}
+
+std::uint64_t SharedCurvePublisher::generation() const{
+  return control_->generation.load(std::memory_order_acquire);
+}
+
+void SharedCurvePublisher::unlink(const std::string& name){
+  ::shm_unlink(name.c_str());
+}
+
+SharedCurveReader::SharedCurveReader(const std::string& name){
+  auto fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open shared curves " + name);
+  struct stat status{};
+  if (::fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(shared_curves::slot_offset)) {
+    ::close(fd);
+    throw std::runtime_error("Shared curves " + name + " are not initialized");
+  }
+  size_ = static_cast<std::size_t>(status.st_size);
+  auto* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+    throw std::runtime_error("Cannot map shared curves " + name);
+  data_ = static_cast<const std::byte*>(mapping);
+  control_ = reinterpret_cast<const shared_curves::Control*>(data_);
+
+  auto valid = std::memcmp(control_->magic, magic, sizeof magic) == 0;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (!valid || control_->format_version != shared_curves::format_version ||
+      object_size(control_->capacity) != size_) {
+    ::munmap(const_cast<std::byte*>(data_), size_);
+    throw std::runtime_error("Shared curves " + name + " are not initialized or of another format");
+  }
+}
+
+SharedCurveReader::~SharedCurveReader(){
+  ::munmap(const_cast<std::byte*>(data_), size_);
+}
+
+std::uint64_t SharedCurveReader::generation() const{
+  return control_->generation.load(std::memory_order_acquire);
+}
+
+std::span<const CurveView> SharedCurveReader::views(std::uint64_t generation){
+  if (generation != cached_generation_) {
+    auto slot = generation % 2;
+    auto length = std::min<std::uint64_t>(control_->length[slot].load(std::memory_order_relaxed), control_->capacity);
+    cached_generation_ = 0;
+    cached_views_ = CurveSnapshot::parse({data_ + shared_curves::slot_offset + slot * slot_stride(control_->capacity),
+                                          static_cast<std::size_t>(length)});
+    cached_generation_ = generation;
+  }
+  return cached_views_;
+}
+
+bool SharedCurveReader::overwritten(std::uint64_t generation) const{
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return control_->writing.load(std::memory_order_relaxed) >= generation + 2;
+}
@@ -59,7 +59,7 @@ date is the first actual payment date. */
   auto dc = DayCount{day_count_type_};
   auto calendar = Calendar{cal_type_};
   std::vector<ChronoDate> start_accrual_dates{},end_accrual_dates{};
-  std::vector<double> year_fracs{},rates{};
+  std::vector<double> rates{};
   std::vector<unsigned int> accrued_days{};
   for (auto next_dt : schedule_dates | std::views::drop(1)){
     start_accrual_dates.push_back(prev_dt);
@@ -71,51 +71,84 @@ date is the first actual payment date. */
     std::tuple<double,unsigned int, unsigned int> temp = dc.year_frac(prev_dt,next_dt,FrequencyTypes::ANNUAL);
     rates.push_back(coupon_);
     payments_.push_back(std::get<0>(temp) * notional_ * coupon_);
-    year_fracs.push_back(std::get<0>(temp));
+    year_fracs_.push_back(std::get<0>(temp));
     accrued_days.push_back(std::get<1>(temp));
     prev_dt = next_dt;
   }
   return payment_dates_;
 }
 
-double SwapFixedLeg::value(const ChronoDate& val_date, const DiscountCurve& disc_curve) {
+double SwapFixedLeg::value(const ChronoDate& val_date, const DiscountCurve& disc_curve) const{
+  return pv(val_date, disc_curve);
+}
+
+double SwapFixedLeg::pv(const ChronoDate& val_date, const DiscountCurve& disc_curve) const{
   auto df_value = disc_curve.df(val_date);
-  double leg_pv{},df_pmnt{};
-  ChronoDate pmnt_dt{};
   auto num_payments = payment_dates_.size();
+  double leg_pv{};
   for (size_t i{0}; i < num_payments; ++i){
-    pmnt_dt = payment_dates_[i];
-    auto pmnt_amount = payments_[i];
-    if (pmnt_dt > val_date){
-      df_pmnt = disc_curve.df(pmnt_dt) / df_value;
-      auto pmnt_pv = pmnt_amount * df_pmnt;
-      leg_pv += pmnt_pv;
-
-      payment_dfs_.push_back(df_pmnt);
-      payment_pvs_.push_back(pmnt_pv);
-      cumulative_pvs_.push_back(leg_pv);
-
-    } else {
-      payment_dfs_.push_back(0.0);
-      payment_pvs_.push_back(0.0);
-      cumulative_pvs_.push_back(0.0);
+    if (payment_dates_[i] > val_date){
+      auto pmnt_amount = payments_[i] + (i + 1 == num_payments ? principal_ * notional_ : 0.0);
+      leg_pv += pmnt_amount * disc_curve.df(payment_dates_[i]) / df_value;
     }
   }
-  //this is suspect code
-  //leg_pv = 0.0;
-  if (pmnt_dt > val_date){
-    auto payment_pv = principal_ * df_pmnt * notional_;
-    payment_pvs_.back() += payment_pv;
-    leg_pv += payment_pv;
-    cumulative_pvs_.back() = leg_pv;
-  }
   if (leg_type_ == SwapTypes::PAY)
     leg_pv = (-1.0)*leg_pv;
-
   return leg_pv;
 }
 
+void SwapFixedLeg::append_cashflows(const ChronoDate& val_date, const DiscountCurve& curve,
+                                    std::vector<PlannedCashflow>& cashflows) const{
+  auto sign = leg_type_ == SwapTypes::PAY ? -1.0 : 1.0;
+  auto num_payments = payment_dates_.size();
+  std::vector<double> pay_times(num_payments);
+  curve.times(payment_dates_, pay_times);
+  for (size_t i{0}; i < num_payments; ++i){
+    if (!(payment_dates_[i] > val_date))
+      continue;
+    auto pmnt_amount = payments_[i] + (i + 1 == num_payments ? principal_ * notional_ : 0.0);
+    cashflows.push_back({.pay_time = pay_times[i], .amount = sign * pmnt_amount});
+  }
+}
+
+double SwapFixedLeg::cashflow_report(const ChronoDate& val_date, const DiscountCurve& disc_curve,
+                                     CashflowReport& report) const{
+  auto df_value = disc_curve.df(val_date);
+  auto num_payments = payment_dates_.size();
+  report.resize(num_payments);
+  double leg_pv{};
+  for (size_t i{0}; i < num_payments; ++i){
+    report.payment_dates[i] = payment_dates_[i];
+    report.rates[i] = coupon_;
+    report.payments[i] = payments_[i];
+    report.payment_dfs[i] = report.payment_pvs[i] = report.cumulative_pvs[i] = 0.0;
+    if (payment_dates_[i] > val_date){
+      auto df_pmnt = disc_curve.df(payment_dates_[i]) / df_value;
+      auto pmnt_pv = (payments_[i] + (i + 1 == num_payments ? principal_ * notional_ : 0.0)) * df_pmnt;
+      leg_pv += pmnt_pv;
+      report.payment_dfs[i] = df_pmnt;
+      report.payment_pvs[i] = pmnt_pv;
+      report.cumulative_pvs[i] = leg_pv;
+    }
+  }
+  return leg_type_ == SwapTypes::PAY ? -leg_pv : leg_pv;
+}
+
+double SwapFixedLeg::annuity(const ChronoDate& val_date, const DiscountCurve& disc_curve) const{
+  auto df_value = disc_curve.df(val_date);
+  double annuity{};
+  for (size_t i{0}; i < payment_dates_.size(); ++i)
+    if (payment_dates_[i] > val_date)
+      annuity += year_fracs_[i] * disc_curve.df(payment_dates_[i]) / df_value;
+  return annuity * notional_;
+}
+
 double SwapFixedLeg::get_coupon() const {return coupon_;}
+void SwapFixedLeg::set_coupon(double coupon){
+  coupon_ = coupon;
+  for (size_t i{0}; i < payments_.size(); ++i)
+    payments_[i] = year_fracs_[i] * notional_ * coupon_;
+}
 double SwapFixedLeg::get_notional() const { return notional_;}
 std::vector<ChronoDate> SwapFixedLeg::get_payment_dates() const { return payment_dates_;}
 
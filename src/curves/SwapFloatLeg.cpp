@@ -68,60 +68,97 @@ coupons cannot be generated yet as we do not have the index curve. */
 }
 
 double SwapFloatLeg::value(const ChronoDate& val_date, const DiscountCurve& disc_curve,
-            const DiscountCurve& index_curve,std::optional<double> first_fixing_rate){
+            const DiscountCurve& index_curve,std::optional<double> first_fixing_rate) const{
+  return pv(val_date, disc_curve, index_curve, first_fixing_rate);
+}
+
+double SwapFloatLeg::pv(const ChronoDate& val_date, const DiscountCurve& disc_curve,
+                        const DiscountCurve& index_curve, std::optional<double> first_fixing_rate) const{
   auto df_value = disc_curve.df(val_date);
-  double leg_pv{},df_pmnt{};
-  ChronoDate pmnt_dt{};
-  bool first_payment = false;
   auto num_payments = payment_dates_.size();
-  auto index_basis = index_curve.day_count_type_;
-  auto index_day_counter = DayCount(index_basis);
-  for (size_t i{0}; i < num_payments; ++i){
-    pmnt_dt = payment_dates_[i];
-    if (pmnt_dt > val_date){
-      auto start_accrued_dt = start_accrual_dates_[i];
-      auto end_accrued_dt = end_accrual_dates_[i];
-      auto pay_alpha = year_fracs_[i];
-      std::tuple<double,unsigned int, unsigned int> temp = index_day_counter.year_frac(
-          start_accrued_dt,end_accrued_dt,FrequencyTypes::ANNUAL);
-      double fwd_rate{};
-      if (!first_payment && first_fixing_rate.has_value()){
-        fwd_rate = first_fixing_rate.value();
-        first_payment = true;
-      } else {
-        auto df_start = index_curve.df(start_accrued_dt);
-        auto df_end = index_curve.df(end_accrued_dt);
-        fwd_rate = (df_start / df_end - 1.0) / std::get<0>(temp);
-      }
-      auto pmnt_amount = (fwd_rate + spread_) * pay_alpha * notional_;
-
-      auto df_pmnt = disc_curve.df(pmnt_dt) / df_value;
-      auto pmnt_pv = pmnt_amount * df_pmnt;
-      leg_pv += pmnt_pv;
+  auto first_paid = first_paid_payment(val_date);
+  double leg_pv{};
+  for (size_t i{first_paid}; i < num_payments; ++i){
+    auto fwd_rate = i == first_paid && first_fixing_rate.has_value() ? first_fixing_rate.value()
+                                                                      : forward_rate(i, index_curve);
+    auto pmnt_amount = (fwd_rate + spread_) * year_fracs_[i] * notional_ +
+                       (i + 1 == num_payments ? principal_ * notional_ : 0.0);
+    leg_pv += pmnt_amount * disc_curve.df(payment_dates_[i]) / df_value;
+  }
+  if (leg_type_ == SwapTypes::PAY)
+    leg_pv = (-1.0)*leg_pv;
+  return leg_pv;
+}
 
-      rates_.push_back(fwd_rate);
-      payments_.push_back(pmnt_amount);
-      payment_dfs_.push_back(df_pmnt);
-      payment_pvs_.push_back(pmnt_pv);
-      cumulative_pvs_.push_back(leg_pv);
+void SwapFloatLeg::append_cashflows(const ChronoDate& val_date, const DiscountCurve& curve,
+                                    std::optional<double> first_fixing_rate,
+                                    std::vector<PlannedCashflow>& cashflows) const{
+  auto sign = leg_type_ == SwapTypes::PAY ? -1.0 : 1.0;
+  auto num_payments = payment_dates_.size();
+  auto first_paid = first_paid_payment(val_date);
+  auto index_day_counter = DayCount(curve.day_count_type_);
+  std::vector<double> pay_times(num_payments), start_times(num_payments), end_times(num_payments);
+  curve.times(payment_dates_, pay_times);
+  curve.times(start_accrual_dates_, start_times);
+  curve.times(end_accrual_dates_, end_times);
+  for (size_t i{first_paid}; i < num_payments; ++i){
+    auto accrual = sign * year_fracs_[i] * notional_;
+    PlannedCashflow cashflow{.pay_time = pay_times[i], .amount = spread_ * accrual};
+    if (i + 1 == num_payments)
+      cashflow.amount += sign * principal_ * notional_;
+    if (i == first_paid && first_fixing_rate.has_value()){
+      cashflow.amount += first_fixing_rate.value() * accrual;
     } else {
-      rates_.push_back(0.0);
-      payments_.push_back(0.0);
-      payment_dfs_.push_back(0.0);
-      payment_pvs_.push_back(0.0);
-      cumulative_pvs_.push_back(0.0);
+      cashflow.weight = accrual;
+      cashflow.start_time = start_times[i];
+      cashflow.end_time = end_times[i];
+      cashflow.alpha = std::get<0>(index_day_counter.year_frac(start_accrual_dates_[i], end_accrual_dates_[i],
+                                                               FrequencyTypes::ANNUAL));
     }
+    cashflows.push_back(cashflow);
   }
-  if (pmnt_dt > val_date){
-    auto payment_pv = principal_ * df_pmnt * notional_;
-    payment_pvs_.back() += payment_pv;
-    leg_pv += payment_pv;
-    cumulative_pvs_.back() = leg_pv;
+}
+
+double SwapFloatLeg::cashflow_report(const ChronoDate& val_date, const DiscountCurve& disc_curve,
+                                     const DiscountCurve& index_curve, std::optional<double> first_fixing_rate,
+                                     CashflowReport& report) const{
+  auto df_value = disc_curve.df(val_date);
+  auto num_payments = payment_dates_.size();
+  auto first_paid = first_paid_payment(val_date);
+  report.resize(num_payments);
+  double leg_pv{};
+  for (size_t i{0}; i < num_payments; ++i){
+    report.payment_dates[i] = payment_dates_[i];
+    report.rates[i] = report.payments[i] = report.payment_dfs[i] = 0.0;
+    report.payment_pvs[i] = report.cumulative_pvs[i] = 0.0;
+    if (i < first_paid)
+      continue;
+    auto fwd_rate = i == first_paid && first_fixing_rate.has_value() ? first_fixing_rate.value()
+                                                                      : forward_rate(i, index_curve);
+    auto pmnt_amount = (fwd_rate + spread_) * year_fracs_[i] * notional_;
+    auto df_pmnt = disc_curve.df(payment_dates_[i]) / df_value;
+    auto pmnt_pv = (pmnt_amount + (i + 1 == num_payments ? principal_ * notional_ : 0.0)) * df_pmnt;
+    leg_pv += pmnt_pv;
+    report.rates[i] = fwd_rate;
+    report.payments[i] = pmnt_amount;
+    report.payment_dfs[i] = df_pmnt;
+    report.payment_pvs[i] = pmnt_pv;
+    report.cumulative_pvs[i] = leg_pv;
   }
-  if (leg_type_ == SwapTypes::PAY)
-    leg_pv = (-1.0)*leg_pv;
+  return leg_type_ == SwapTypes::PAY ? -leg_pv : leg_pv;
+}
 
-  return leg_pv;
+std::size_t SwapFloatLeg::first_paid_payment(const ChronoDate& val_date) const{
+  std::size_t first{0};
+  while (first < payment_dates_.size() && !(payment_dates_[first] > val_date))
+    ++first;
+  return first;
+}
+
+double SwapFloatLeg::forward_rate(std::size_t i, const DiscountCurve& index_curve) const{
+  auto index_alpha = std::get<0>(DayCount(index_curve.day_count_type_).year_frac(start_accrual_dates_[i], end_accrual_dates_[i],
+                                                                                FrequencyTypes::ANNUAL));
+  return (index_curve.df(start_accrual_dates_[i]) / index_curve.df(end_accrual_dates_[i]) - 1.0) / index_alpha;
 }
 
 DayCountTypes SwapFloatLeg::get_day_count_type() const {
@@ -45,12 +45,12 @@ MatrixXd GaussCopula::default_times_gc(const std::vector<CreditCurve>& issuer_cu
   MatrixXd corr_times = MatrixXd::Zero(num_credits, 2 * num_trials);
 
   for (auto i{0};i<num_credits;++i){
+    const auto& times = issuer_curves[i].times_;
+    const auto& values = issuer_curves[i].values_;
     for (auto t{0}; t < num_trials;++t){
       auto g = y(i, t);
       auto u1 = 1.0 - N(g);
       auto u2 = 1.0 - u1;
-      auto times = issuer_curves[i].times_;
-      auto values = issuer_curves[i].values_;
       auto t1 = uniform_to_default_time(u1, times, values);
       auto t2 = uniform_to_default_time(u2, times, values);
       corr_times(i,t) = t1;
@@ -0,0 +1,146 @@
+#include <finproj/models/PcaScenarioGenerator.h>
+#include <finproj/utils/VecMath.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+PcaScenarioGenerator::PcaScenarioGenerator(const std::vector<double>& times, const Eigen::MatrixXd& zero_history,
+                                           Eigen::Index num_factors):times_{times}{
+  auto num_nodes = static_cast<Eigen::Index>(times_.size());
+  if (zero_history.cols() != num_nodes)
+    throw std::runtime_error("Zero rate history needs one column per node time");
+  for (std::size_t j{0}; j < times_.size(); ++j)
+    if (!(times_[j] > (j == 0 ? 0.0 : times_[j - 1])))
+      throw std::runtime_error("Node times must be positive and increasing");
+  if (zero_history.rows() < 3)
+    throw std::runtime_error("Zero rate history needs at least three curves");
+  if (num_factors < 1 || num_factors > num_nodes)
+    throw std::runtime_error("Number of factors must lie between one and the number of nodes");
+
+  auto num_changes = zero_history.rows() - 1;
+  Eigen::MatrixXd changes = zero_history.bottomRows(num_changes) - zero_history.topRows(num_changes);
+  changes.rowwise() -= changes.colwise().mean();
+  Eigen::MatrixXd covariance = changes.transpose() * changes / static_cast<double>(num_changes - 1);
+  total_variance_ = covariance.trace();
+
+  /** The solver sorts the eigenvalues increasingly, the kept factors are the last ones */
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(covariance);
+  if (solver.info() != Eigen::Success)
+    throw std::runtime_error("Eigen decomposition of the rate covariance failed");
+  eigenvalues_ = solver.eigenvalues().tail(num_factors).reverse();
+  components_ = solver.eigenvectors().rightCols(num_factors).rowwise().reverse();
+  // tiny negative eigenvalues are rounding noise of a singular covariance
+  eigenvalues_ = eigenvalues_.cwiseMax(0.0);
+}
+
+PcaScenarioGenerator::PcaScenarioGenerator(const std::vector<double>& times, std::span<const IborSingleCurve> history,
+                                           Eigen::Index num_factors):
+PcaScenarioGenerator(times, [&] {
+  Eigen::MatrixXd zero_history(static_cast<Eigen::Index>(history.size()), static_cast<Eigen::Index>(times.size()));
+  for (std::size_t i{0}; i < history.size(); ++i)
+    zero_history.row(static_cast<Eigen::Index>(i)) = zero_rates(history[i], times).transpose();
+  return zero_history;
+}(), num_factors){}
+
+double PcaScenarioGenerator::explained_variance() const{
+  return total_variance_ > 0.0 ? eigenvalues_.sum() / total_variance_ : 1.0;
+}
+
+Eigen::VectorXd PcaScenarioGenerator::zero_rates(const DiscountCurve& curve, const std::vector<double>& times){
+  Eigen::VectorXd zeros(static_cast<Eigen::Index>(times.size()));
+  auto out = std::span(zeros.data(), times.size());
+  curve.df(times, out);
+  vecmath::log(out, out);
+  for (std::size_t j{0}; j < times.size(); ++j)
+    out[j] = -out[j] / times[j];
+  return zeros;
+}
+
+void PcaScenarioGenerator::fill_block(Eigen::Index block, std::uint64_t seed, const Eigen::MatrixXd& loadings,
+                                      const Eigen::VectorXd& base_zero_rates, Eigen::MatrixXd& rates) const{
+  auto first = block * block_size;
+  auto count = std::min(block_size, rates.rows() - first);
+  std::seed_seq seq{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+                    static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32)};
+  std::mt19937_64 engine(seq);
+
+  /** Box-Muller on 53 bit uniforms, with the logs of the whole block in one batch */
+  Eigen::MatrixXd normals(loadings.rows(), count);
+  auto num_normals = static_cast<std::size_t>(normals.size());
+  auto num_pairs = (num_normals + 1) / 2;
+  std::vector<double> radii(num_pairs), angles(num_pairs);
+  for (std::size_t i{0}; i < num_pairs; ++i) {
+    radii[i] = static_cast<double>((engine() >> 11) + 1) * 0x1.0p-53;
+    angles[i] = static_cast<double>(engine() >> 11) * 0x1.0p-53 * 2.0 * std::numbers::pi;
+  }
+  vecmath::log(radii, radii);
+  auto* z = normals.data();
+  for (std::size_t i{0}; i < num_pairs; ++i) {
+    auto r = std::sqrt(-2.0 * radii[i]);
+    z[2 * i] = r * std::cos(angles[i]);
+    if (2 * i + 1 < num_normals)
+      z[2 * i + 1] = r * std::sin(angles[i]);
+  }
+
+  auto block_rates = rates.middleRows(first, count);
+  block_rates.noalias() = normals.transpose() * loadings;
+  block_rates.rowwise() += base_zero_rates.transpose();
+}
+
+CurveCube PcaScenarioGenerator::generate(const Eigen::VectorXd& base_zero_rates, Eigen::Index num_scenarios,
+                                         std::uint64_t seed, double horizon, InterpTypes interp_type,
+                                         unsigned num_threads) const{
+  if (base_zero_rates.size() != static_cast<Eigen::Index>(times_.size()))
+    throw std::runtime_error("Base zero rates need one entry per node time");
+  if (num_scenarios < 1)
+    throw std::runtime_error("Number of scenarios must be positive");
+  if (!(horizon > 0.0))
+    throw std::runtime_error("Horizon must be positive");
+
+  /** factors by nodes, each row a component scaled by its standard deviation */
+  Eigen::MatrixXd loadings = (components_ * (eigenvalues_ * horizon).cwiseSqrt().asDiagonal()).transpose();
+  Eigen::MatrixXd rates(num_scenarios, base_zero_rates.size());
+  auto num_blocks = (num_scenarios + block_size - 1) / block_size;
+  if (num_threads == 0)
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  num_threads = static_cast<unsigned>(std::min<Eigen::Index>(num_threads, num_blocks));
+
+  std::atomic<Eigen::Index> next_block{0};
+  auto work = [&] {
+    for (auto block = next_block++; block < num_blocks; block = next_block++)
+      fill_block(block, seed, loadings, base_zero_rates, rates);
+  };
+  if (num_threads == 1) {
+    work();
+  } else {
+    /** an exception must not leave a worker, it is rethrown here after the join */
+    std::vector<std::exception_ptr> errors(num_threads);
+    std::vector<std::thread> workers{};
+    workers.reserve(num_threads);
+    for (unsigned i{0}; i < num_threads; ++i)
+      workers.emplace_back([&, i] {
+        try {
+          work();
+        } catch (...) {
+          errors[i] = std::current_exception();
+          next_block = num_blocks;
+        }
+      });
+    for (auto& worker : workers)
+      worker.join();
+    for (const auto& error : errors)
+      if (error)
+        std::rethrow_exception(error);
+  }
+  return {times_, std::move(rates), FrequencyTypes::CONTINUOUS, interp_type};
+}
+
+CurveCube PcaScenarioGenerator::generate(const DiscountCurve& base, Eigen::Index num_scenarios, std::uint64_t seed,
+                                         double horizon, InterpTypes interp_type, unsigned num_threads) const{
+  return generate(zero_rates(base, times_), num_scenarios, seed, horizon, interp_type, num_threads);
+}
@@ -1,5 +1,6 @@
 #include <finproj/models/StudentTCopula.h>
 #include <finproj/curves/CDS.h>
+#include <algorithm>
 #include <random>
 #include <boost/math/distributions/students_t.hpp>
 
@@ -24,17 +25,17 @@ MatrixXd StudentTCopula::default_times(const std::vector<CreditCurve> &issuer_cu
   auto y = (L * x).eval();
   std::default_random_engine generator(seed);
   MatrixXd corr_times = MatrixXd::Zero(num_credits, 2 * num_trials);
+  boost::math::students_t boost_t_dist{degrees_of_freedom};
   for (auto itrial{0};itrial<num_trials;++itrial){
     std::chi_squared_distribution<double> distribution(degrees_of_freedom);
     double chi2 = distribution(generator);
     auto c = sqrt(chi2 / degrees_of_freedom);
     for (auto icredit{0};icredit<num_credits;++icredit){
       auto g = y(icredit, itrial) / c;
-      boost::math::students_t boost_t_dist{degrees_of_freedom};
       auto u1 = boost::math::cdf(boost_t_dist,g);
       auto u2 = 1.0 - u1;
-      auto times = issuer_curves[icredit].times_;
-      auto values = issuer_curves[icredit].values_;
+      const auto& times = issuer_curves[icredit].times_;
+      const auto& values = issuer_curves[icredit].values_;
       auto t1 = StudentTCopula::uniform_to_default_time_student(u1, times, values);
       auto t2 = StudentTCopula::uniform_to_default_time_student(u2, times, values);
       corr_times(icredit,itrial) = t1;
@@ -44,7 +45,7 @@ MatrixXd StudentTCopula::default_times(const std::vector<CreditCurve> &issuer_cu
   return corr_times;
 }
 
-double StudentTCopula::uniform_to_default_time_student(double u, const std::vector<double>& times, const std::vector<double>& values)
+double StudentTCopula::uniform_to_default_time_student(double u, std::span<const double> times, std::span<const double> values)
 {
   if (u == 0.0)
     return 99999.0;
@@ -52,11 +53,10 @@ double StudentTCopula::uniform_to_default_time_student(double u, const std::vect
     return 0.0;
   size_t num_points = times.size();
   size_t index = 0;
-  for (size_t i{1};i<num_points;++i){
-    if (u <= values[i - 1] && u > values[i]){
-      index = i;
-      break;
-    }
+  if (num_points > 1 && u <= values[0]) {
+    auto it = std::partition_point(values.begin() + 1, values.end(), [u](double q) { return q >= u; });
+    if (it != values.end())
+      index = static_cast<size_t>(it - values.begin());
   }
   double tau = 0.0;
   if (index == num_points + 1) {
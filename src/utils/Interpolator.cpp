@@ -1,104 +1,520 @@
 #include <finproj/utils/Interpolator.h>
-#include <libInterpolate/Interpolate.hpp>
-#include <libInterpolate/AnyInterpolator.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <stdexcept>
+#include <utility>
 
-Interpolator::Interpolator(const std::vector<double>& times, const std::vector<double>& dfs, InterpTypes inter_type):
-times_{times},dfs_{dfs},inter_type_{inter_type}{
-  num_points_ = times.size();
+namespace {
+
+std::uint64_t next_version(){
+  static std::atomic<std::uint64_t> counter{0};
+  return counter.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
-Interpolator::Interpolator(){}
+}// namespace
 
-Interpolator::Interpolator(InterpTypes inter_type):inter_type_{inter_type}{}
+SegmentTable::SegmentTable(InterpTypes inter_type):inter_type_{inter_type}{}
 
-void Interpolator::fit(const std::vector<double>& times, const std::vector<double>& dfs){
+SegmentTable::SegmentTable(const std::vector<double>& times, const std::vector<double>& dfs, InterpTypes inter_type):
+times_{times},dfs_{dfs},inter_type_{inter_type}{
+  num_points_ = times.size();
+  build_segments();
+}
+
+void SegmentTable::fit(const std::vector<double>& times, const std::vector<double>& dfs){
   times_ = times;
   dfs_ = dfs;
   num_points_ = times_.size();
+  build_segments();
 }
 
-double Interpolator::interpolate(double t) const{
-  double ret{999};
-
-  if (t < small)
-    return 1.0;
-
-  if (t == times_[0])
-    ret = dfs_[0];
-
-  auto i = 0;
-  while (times_[i] < t && i < num_points_ - 1)
-    i = i + 1;
-  if (t > times_[i])
-    i = num_points_;
-
-  if (inter_type_ == InterpTypes::LINEAR_ZERO_RATES){
-    if (i == 1) {
-      double r1 = -log(dfs_[i]) / times_[i];
-      double r2 = -log(dfs_[i]) / times_[i];
-      double dt = times_[i] - times_[i - 1];
-      double rvalue = ((times_[i] - t) * r1 + (t - times_[i - 1]) * r2) / dt;
-      ret = exp(-rvalue * t);
-    } else if (i < num_points_){
-      double r1 = -log(dfs_[i - 1]) / times_[i - 1];
-      double r2 = -log(dfs_[i]) / times_[i];
-      double dt = times_[i] - times_[i - 1];
-      double rvalue = ((times_[i] - t) * r1 + (t - times_[i - 1]) * r2) / dt;
-      ret = exp(-rvalue * t);
-    } else {
-      double r1 = -log(dfs_[i - 1]) / times_[i - 1];
-      double r2 = -log(dfs_[i - 1]) / times_[i - 1];
-      double dt = times_[i - 1] - times_[i - 2];
-      double rvalue = ((times_[i - 1] - t) * r1 + (t - times_[i - 2]) * r2) / dt;
-      ret = exp(-rvalue * t);
-    }
-  } else if (inter_type_ == InterpTypes::FLAT_FWD_RATES) {
-    if (i == 1) {
-      double rt1 = -log(dfs_[i - 1]);
-      double rt2 = -log(dfs_[i]);
-      double dt = times_[i] - times_[i - 1];
-      double rtvalue = ((times_[i] - t) * rt1 + (t - times_[i - 1]) * rt2) / dt;
-      ret = exp(-rtvalue);
-    } else if (i < num_points_){
-      double rt1 = -log(dfs_[i - 1]);
-      double rt2 = -log(dfs_[i]);
-      double dt = times_[i] - times_[i - 1];
-      double rtvalue = ((times_[i] - t) * rt1 + (t - times_[i - 1]) * rt2) / dt;
-      ret = exp(-rtvalue);
-    } else {
-      double rt1 = -log(dfs_[i - 2]);
-      double rt2 = -log(dfs_[i - 1]);
-      double dt = times_[i - 1] - times_[i - 2];
-      double rtvalue = ((times_[i - 1] - t) * rt1 + (t - times_[i - 2]) * rt2) / dt;
-      ret = exp(-rtvalue);
+void SegmentTable::set_last_value(double df){
+  /** Only the last node moved, so the values and segments in front of it are kept.
+  The local schemes rebuild their last two or three segments, the natural splines
+  resume the cached tridiagonal sweep at its last row. */
+  auto n = static_cast<size_t>(num_points_);
+  if (n == 0)
+    throw std::runtime_error("No nodes to update");
+  dfs_.back() = df;
+  if (n < 3) {
+    build_segments();
+    return;
+  }
+  values_.back() = node_value(n - 1);
+  fit_segments(n - 1);
+  segments_[0] = segments_[1];
+}
+
+void SegmentTable::push_node(double t, double df){
+  /** Appends a node beyond the last one. Only the segments reaching the new node are
+  rebuilt; the natural splines extend their sweep by one row. */
+  if (num_points_ > 0 && !(t > times_.back()))
+    throw std::runtime_error("New node must lie after the last node");
+  times_.push_back(t);
+  dfs_.push_back(df);
+  auto n = static_cast<size_t>(++num_points_);
+  if (n < 3) {
+    build_segments();
+    return;
+  }
+  values_.push_back(node_value(n - 1));
+  derivs_.push_back(0.0);
+  sweep_c_.push_back(0.0);
+  sweep_d_.push_back(0.0);
+  segments_.emplace_back();
+  fit_segments(n - 1);
+  segments_[0] = segments_[1];
+}
+
+void SegmentTable::pop_node(){
+  /** Drops the last node. The sweep rows in front of it stay valid, so this only
+  redoes the new end of the curve. */
+  if (num_points_ == 0)
+    throw std::runtime_error("No nodes to remove");
+  times_.pop_back();
+  dfs_.pop_back();
+  auto n = static_cast<size_t>(--num_points_);
+  if (n < 3) {
+    build_segments();
+    return;
+  }
+  values_.pop_back();
+  derivs_.pop_back();
+  sweep_c_.pop_back();
+  sweep_d_.pop_back();
+  segments_.pop_back();
+  fit_segments(n);
+  segments_[0] = segments_[1];
+}
+
+void SegmentTable::reserve(std::size_t num_points){
+  times_.reserve(num_points);
+  dfs_.reserve(num_points);
+  values_.reserve(num_points);
+  derivs_.reserve(num_points);
+  sweep_c_.reserve(num_points);
+  sweep_d_.reserve(num_points);
+  segments_.reserve(num_points + 1);
+}
+
+void SegmentTable::exponent_gradient(double t, std::span<double> grad) const{
+  /** Works in two steps. First dp/dv_j, where p is the segment polynomial and v_j the
+  node values it interpolates (values_). Then the zero rate factor t, the z0 = z1 tie
+  and dv_j/d(df_j) are applied per node. The natural splines add the path through the
+  second derivatives, m = A^-1 R v, as R^T A^-1 (dp/dm) with one solve against the
+  cached sweep. */
+  auto n = static_cast<size_t>(num_points_);
+  if (grad.size() != n)
+    throw std::runtime_error("Gradient must have one entry per node");
+  std::fill(grad.begin(), grad.end(), 0.0);
+  if (n == 0)
+    return;
+  if (n == 1) {
+    grad[0] = -1.0 / dfs_[0] * (zero_rates_ ? t / fmax(times_[0], small) : 1.0);
+    return;
+  }
+  auto i = find_segment(t);
+  auto k = std::clamp<size_t>(i, 1, n - 1);
+  auto u = t - times_[k - 1];
+  auto h = times_[k] - times_[k - 1];
+  switch (inter_type_) {
+    case InterpTypes::FLAT_FWD_RATES:
+      grad[k - 1] = 1.0 - u / h;
+      grad[k] = u / h;
+      break;
+    case InterpTypes::LINEAR_ZERO_RATES:
+      if (i <= 1) {
+        grad[1] = 1.0;
+      } else if (i == n) {
+        grad[n - 1] = 1.0;
+      } else {
+        grad[k - 1] = 1.0 - u / h;
+        grad[k] = u / h;
+      }
+      break;
+    case InterpTypes::LINEAR_FWD_RATES:
+      if (i <= 1) {
+        // first segment is t * -log(df_1 + small) / (t_1 + small), not in values_
+        grad[1] = -t / ((dfs_[1] + small) * (times_[1] + small));
+        return;
+      } else if (i == n) {
+        auto w = (t - times_[n - 1]) / (times_[n - 1] - times_[n - 2]);
+        grad[n - 1] = 1.0 + w;
+        grad[n - 2] = -w;
+      } else {
+        auto h1 = times_[i - 1] - times_[i - 2];
+        auto q = u * u / h;
+        grad[i] = q / h;
+        grad[i - 1] = 1.0 + (u - q) / h1 - q / h;
+        grad[i - 2] = -(u - q) / h1;
+      }
+      break;
+    case InterpTypes::FINCUBIC_ZERO_RATES:
+    case InterpTypes::NATCUBIC_ZERO_RATES:
+    case InterpTypes::NATCUBIC_LOG_DISCOUNT: {
+      grad[k - 1] = 1.0 - u / h;
+      grad[k] = u / h;
+      // dp/dm at the two ends of the interval, then w = A^-1 dp/dm on rows 1..n-2
+      std::vector<double> w(n, 0.0);
+      w[k - 1] = -h * u / 3.0 + 0.5 * u * u - u * u * u / (6.0 * h);
+      w[k] = -h * u / 6.0 + u * u * u / (6.0 * h);
+      w[0] = w[n - 1] = 0.0;
+      for (size_t j{1}; j + 1 < n; ++j) {
+        auto h0 = times_[j] - times_[j - 1];
+        auto denom = 2.0 * (times_[j + 1] - times_[j - 1]) - h0 * sweep_c_[j - 1];
+        w[j] = (w[j] - h0 * w[j - 1]) / denom;
+      }
+      for (size_t j = n - 2; j >= 1; --j)
+        w[j] -= sweep_c_[j] * w[j + 1];
+      for (size_t j{1}; j + 1 < n; ++j) {
+        auto h0 = times_[j] - times_[j - 1];
+        auto h1 = times_[j + 1] - times_[j];
+        grad[j - 1] += 6.0 * w[j] / h0;
+        grad[j] -= 6.0 * w[j] * (1.0 / h0 + 1.0 / h1);
+        grad[j + 1] += 6.0 * w[j] / h1;
+      }
+      break;
     }
-  } else if (inter_type_ == InterpTypes::LINEAR_FWD_RATES) {
-    if (i == 1) {
-      double y2 = -log(dfs_[i] + small);
-      double yvalue = t * y2 / (times_[i] + small);
-      ret = exp(-yvalue);
-    } else if (i < num_points_){
-      double fwd1 = -log(dfs_[i - 1] / dfs_[i - 2]) / (times_[i - 1] - times_[i - 2]);
-      double fwd2 = -log(dfs_[i] / dfs_[i - 1]) / (times_[i] - times_[i - 1]);
-      double dt = times_[i] - times_[i - 1];
-      double fwd = ((times_[i] - t) * fwd1 + (t - times_[i - 1]) * fwd2) / dt;
-      ret = dfs_[i - 1] * exp(-fwd * (t - times_[i - 1]));
-    } else {
-      double fwd = -log(dfs_[i - 1] / dfs_[i - 2]) / (times_[i - 1] - times_[i - 2]);
-      ret = dfs_[i - 1] * exp(-fwd * (t - times_[i - 1]));
+    case InterpTypes::PCHIP_ZERO_RATES:
+    case InterpTypes::PCHIP_LOG_DISCOUNT: {
+      // Hermite basis on the interval, the node slopes then spread onto their stencils
+      auto s = u / h;
+      grad[k - 1] = 2.0 * s * s * s - 3.0 * s * s + 1.0;
+      grad[k] = -2.0 * s * s * s + 3.0 * s * s;
+      auto dp_ds0 = h * (s * s * s - 2.0 * s * s + s);
+      auto dp_ds1 = h * (s * s * s - s * s);
+      for (auto [j, dp_ds] : {std::pair{k - 1, dp_ds0}, std::pair{k, dp_ds1}}) {
+        if (n == 2) {
+          grad[0] -= dp_ds / h;
+          grad[1] += dp_ds / h;
+          continue;
+        }
+        if (j == 0 || j == n - 1) {
+          // three point end formula, zero or 3 * m0 where it is clipped
+          auto last = j == n - 1;
+          auto a = last ? n - 1 : 1, b = last ? n - 2 : 2;
+          auto h0 = fabs(times_[a] - times_[a - 1]), h1 = fabs(times_[b] - times_[b - 1]);
+          auto m0 = slope(a), m1 = slope(b);
+          auto d0 = (2.0 * h0 + h1) / (h0 + h1), d1 = -h0 / (h0 + h1);
+          if (derivs_[j] == 0.0) {
+            d0 = d1 = 0.0;
+          } else if (derivs_[j] == 3.0 * m0 && (m0 > 0.0) != (m1 > 0.0)) {
+            d0 = 3.0;
+            d1 = 0.0;
+          }
+          grad[a] += dp_ds * d0 / h0;
+          grad[a - 1] -= dp_ds * d0 / h0;
+          grad[b] += dp_ds * d1 / h1;
+          grad[b - 1] -= dp_ds * d1 / h1;
+        } else {
+          auto m0 = slope(j), m1 = slope(j + 1);
+          if (m0 * m1 <= 0.0)
+            continue;
+          auto h0 = times_[j] - times_[j - 1];
+          auto h1 = times_[j + 1] - times_[j];
+          auto w1 = 2.0 * h1 + h0;
+          auto w2 = h1 + 2.0 * h0;
+          auto d = derivs_[j];
+          auto dd_dm0 = d * d * w1 / ((w1 + w2) * m0 * m0);
+          auto dd_dm1 = d * d * w2 / ((w1 + w2) * m1 * m1);
+          grad[j - 1] -= dp_ds * dd_dm0 / h0;
+          grad[j] += dp_ds * (dd_dm0 / h0 - dd_dm1 / h1);
+          grad[j + 1] += dp_ds * dd_dm1 / h1;
+        }
+      }
+      break;
     }
-  } else if (inter_type_ == InterpTypes::FINCUBIC_ZERO_RATES) {
-    std::vector<double> zero_rates{};
-    for (size_t j{0}; j < dfs_.size();++j){
-      zero_rates.push_back(-log(dfs_[j]) / (times_[j] + small));
+  }
+  if (zero_rates_ && times_[0] == 0.0) {
+    grad[1] += grad[0];
+    grad[0] = 0.0;
+  }
+  for (size_t j{0}; j < n; ++j) {
+    auto dv_ddf = -1.0 / dfs_[j];
+    if (inter_type_ == InterpTypes::LINEAR_ZERO_RATES)
+      dv_ddf /= times_[j];
+    else if (zero_rates_)
+      dv_ddf /= times_[j] + small;
+    grad[j] *= (zero_rates_ ? t : 1.0) * (grad[j] == 0.0 ? 0.0 : dv_ddf);
+  }
+}
+
+double SegmentTable::last_exponent_gradient(double t) const{
+  auto n = static_cast<size_t>(num_points_);
+  if (n == 0)
+    throw std::runtime_error("No nodes to differentiate");
+  if (n < 2 || (inter_type_ != InterpTypes::FLAT_FWD_RATES && inter_type_ != InterpTypes::LINEAR_ZERO_RATES)) {
+    std::vector<double> grad(n);
+    exponent_gradient(t, grad);
+    return grad.back();
+  }
+  /** The same cases as exponent_gradient, keeping only the entry of the last node */
+  auto last = n - 1;
+  auto i = find_segment(t);
+  auto k = std::clamp<size_t>(i, 1, last);
+  auto w = (t - times_[k - 1]) / (times_[k] - times_[k - 1]);
+  double dv{};
+  if (inter_type_ == InterpTypes::FLAT_FWD_RATES)
+    dv = k == last ? w : 0.0;
+  else if (i <= 1)
+    dv = last == 1 ? 1.0 : 0.0;
+  else if (i == n)
+    dv = 1.0;
+  else
+    dv = i == last ? w : 0.0;
+  if (dv == 0.0)
+    return 0.0;
+  if (inter_type_ == InterpTypes::LINEAR_ZERO_RATES)
+    return t * dv * (-1.0 / dfs_[last] / times_[last]);
+  return dv * (-1.0 / dfs_[last]);
+}
+
+double SegmentTable::node_value(std::size_t i) const{
+  auto y = -log(dfs_[i]);
+  if (inter_type_ == InterpTypes::LINEAR_ZERO_RATES)
+    return y / times_[i];
+  if (zero_rates_)
+    return y / (times_[i] + small);
+  return y;
+}
+
+void SegmentTable::build_segments(){
+  /** All logs and slopes are taken once here so that interpolate() is a segment
+  lookup followed by a single exp. Segment i reproduces the formula the scheme uses
+  for t in (times_[i-1], times_[i]], including the special first and extrapolated
+  segments. */
+  auto n = static_cast<size_t>(num_points_);
+  version_ = next_version();
+  zero_rates_ = inter_type_ == InterpTypes::LINEAR_ZERO_RATES ||
+                inter_type_ == InterpTypes::FINCUBIC_ZERO_RATES ||
+                inter_type_ == InterpTypes::NATCUBIC_ZERO_RATES ||
+                inter_type_ == InterpTypes::PCHIP_ZERO_RATES;
+  segments_.assign(n + 1, Segment{});
+  values_.resize(n);
+  derivs_.assign(n, 0.0);
+  sweep_c_.assign(n, 0.0);
+  sweep_d_.assign(n, 0.0);
+  if (n == 0)
+    return;
+  if (n == 1) {
+    auto y = -log(dfs_[0]);
+    if (zero_rates_)
+      y /= fmax(times_[0], small);
+    segments_[0] = segments_[1] = Segment{times_[0], y, 0.0, 0.0, 0.0};
+    return;
+  }
+  for (size_t j{0}; j < n; ++j)
+    values_[j] = node_value(j);
+  if (zero_rates_ && times_[0] == 0.0)
+    values_[0] = values_[1];
+  fit_segments(1);
+  segments_[0] = segments_[1];
+}
+
+void SegmentTable::fit_segments(std::size_t first){
+  /** Rebuilds segments_[first..n] from values_, assuming everything in front of
+  values_[first] is unchanged since the last fit. */
+  version_ = next_version();
+  auto n = values_.size();
+  if (zero_rates_ && times_[0] == 0.0 && first <= 1) {
+    values_[0] = values_[1];
+    first = 1;
+  }
+  switch (inter_type_) {
+    case InterpTypes::FLAT_FWD_RATES:
+      for (size_t i{first}; i < n; ++i)
+        segments_[i] = Segment{times_[i - 1], values_[i - 1], slope(i), 0.0, 0.0};
+      segments_[n] = Segment{times_[n - 1], values_[n - 1], segments_[n - 1].b, 0.0, 0.0};
+      break;
+    case InterpTypes::LINEAR_ZERO_RATES:
+      segments_[1] = Segment{times_[0], values_[1], 0.0, 0.0, 0.0};
+      for (size_t i{std::max<size_t>(first, 2)}; i < n; ++i)
+        segments_[i] = Segment{times_[i - 1], values_[i - 1], slope(i), 0.0, 0.0};
+      segments_[n] = Segment{times_[n - 1], values_[n - 1], 0.0, 0.0, 0.0};
+      break;
+    case InterpTypes::LINEAR_FWD_RATES:
+      segments_[1] = Segment{0.0, 0.0, -log(dfs_[1] + small) / (times_[1] + small), 0.0, 0.0};
+      for (size_t i{std::max<size_t>(first, 2)}; i < n; ++i) {
+        auto fwd1 = slope(i - 1);
+        segments_[i] = Segment{times_[i - 1], values_[i - 1], fwd1,
+                               (slope(i) - fwd1) / (times_[i] - times_[i - 1]), 0.0};
+      }
+      segments_[n] = Segment{times_[n - 1], values_[n - 1], slope(n - 1), 0.0, 0.0};
+      break;
+    case InterpTypes::FINCUBIC_ZERO_RATES:
+    case InterpTypes::NATCUBIC_ZERO_RATES:
+    case InterpTypes::NATCUBIC_LOG_DISCOUNT:
+      fit_natural_spline(first);
+      break;
+    case InterpTypes::PCHIP_ZERO_RATES:
+    case InterpTypes::PCHIP_LOG_DISCOUNT:
+      fit_pchip(first);
+      break;
+  }
+}
+
+double SegmentTable::slope(std::size_t i) const{
+  return (values_[i] - values_[i - 1]) / (times_[i] - times_[i - 1]);
+}
+
+void SegmentTable::fit_natural_spline(std::size_t first){
+  /** Natural cubic spline through (times_[i], values_[i]). The second derivatives m
+  solve a tridiagonal system with m = 0 at both ends. The forward sweep is kept in
+  sweep_c_/sweep_d_; row i only sees values up to i + 1, so a refit restarts the sweep
+  at first - 1. The back substitution and the segments are always redone since every
+  m moves. Each interval is stored as its cubic in t - times_[i-1] and the end cubics
+  are continued outside the node range. */
+  auto n = values_.size();
+  auto& m = derivs_;
+  m[n - 1] = 0.0;
+  for (size_t i{std::max<size_t>(first, 2) - 1}; i + 1 < n; ++i) {
+    auto h0 = times_[i] - times_[i - 1];
+    auto h1 = times_[i + 1] - times_[i];
+    auto rhs = 6.0 * (slope(i + 1) - slope(i));
+    auto denom = 2.0 * (h0 + h1) - h0 * sweep_c_[i - 1];
+    sweep_c_[i] = h1 / denom;
+    sweep_d_[i] = (rhs - h0 * sweep_d_[i - 1]) / denom;
+  }
+  for (size_t i = n - 2; i >= 1; --i)
+    m[i] = sweep_d_[i] - sweep_c_[i] * m[i + 1];
+  for (size_t i{1}; i < n; ++i) {
+    auto h = times_[i] - times_[i - 1];
+    segments_[i] = Segment{times_[i - 1], values_[i - 1],
+                           slope(i) - h * (2.0 * m[i - 1] + m[i]) / 6.0,
+                           0.5 * m[i - 1], (m[i] - m[i - 1]) / (6.0 * h)};
+  }
+  segments_[n] = segments_[n - 1];
+}
+
+void SegmentTable::fit_pchip(std::size_t first){
+  /** Monotone piecewise cubic Hermite interpolant (Fritsch-Carlson). Node slopes are
+  the weighted harmonic mean of the adjacent secants, zero at local extrema, with the
+  shape preserving three point formula at the ends. A slope only sees its neighbouring
+  nodes, so a refit from first touches the last few slopes and segments. */
+  auto n = values_.size();
+  auto& d = derivs_;
+  auto from = first <= 2 ? size_t{0} : first - 1;
+  if (n == 2) {
+    d[0] = d[1] = slope(1);
+  } else {
+    auto sign = [](double x) { return (x > 0.0) - (x < 0.0); };
+    auto end_slope = [&sign](double h0, double h1, double m0, double m1) {
+      auto s = ((2.0 * h0 + h1) * m0 - h0 * m1) / (h0 + h1);
+      if (sign(s) != sign(m0))
+        return 0.0;
+      if (sign(m0) != sign(m1) && fabs(s) > 3.0 * fabs(m0))
+        return 3.0 * m0;
+      return s;
+    };
+    if (from == 0)
+      d[0] = end_slope(times_[1] - times_[0], times_[2] - times_[1], slope(1), slope(2));
+    for (size_t i{std::max<size_t>(from, 1)}; i + 1 < n; ++i) {
+      auto m0 = slope(i);
+      auto m1 = slope(i + 1);
+      if (m0 * m1 <= 0.0) {
+        d[i] = 0.0;
+      } else {
+        auto h0 = times_[i] - times_[i - 1];
+        auto h1 = times_[i + 1] - times_[i];
+        auto w1 = 2.0 * h1 + h0;
+        auto w2 = h1 + 2.0 * h0;
+        d[i] = (w1 + w2) / (w1 / m0 + w2 / m1);
+      }
     }
-    if (times_[0] == 0.0)
-      zero_rates[0] = zero_rates[1];
+    d[n - 1] = end_slope(times_[n - 1] - times_[n - 2], times_[n - 2] - times_[n - 3],
+                         slope(n - 1), slope(n - 2));
+  }
+  for (size_t i{std::max<size_t>(from, 1)}; i < n; ++i) {
+    auto h = times_[i] - times_[i - 1];
+    auto m = slope(i);
+    segments_[i] = Segment{times_[i - 1], values_[i - 1], d[i - 1],
+                           (3.0 * m - 2.0 * d[i - 1] - d[i]) / h,
+                           (d[i - 1] + d[i] - 2.0 * m) / (h * h)};
+  }
+  segments_[n] = segments_[n - 1];
+}
+
+Interpolator::Interpolator(const std::vector<double>& times, const std::vector<double>& dfs, InterpTypes inter_type):
+impl_{make(inter_type)}{
+  fit(times, dfs);
+}
+
+Interpolator::Interpolator(){}
+
+Interpolator::Interpolator(InterpTypes inter_type):impl_{make(inter_type)}{}
 
-    _1D::CubicSplineInterpolator<double> interp;
-    interp.setData( times_, zero_rates );
-    ret = exp(-t * interp(t));
+Interpolator::Variant Interpolator::make(InterpTypes inter_type){
+  switch (inter_type) {
+    case InterpTypes::FLAT_FWD_RATES:
+      return BasicInterpolator<FlatFwd>{inter_type};
+    case InterpTypes::LINEAR_ZERO_RATES:
+      return BasicInterpolator<LinearZero>{inter_type};
+    case InterpTypes::LINEAR_FWD_RATES:
+      return BasicInterpolator<LinearFwd>{inter_type};
+    case InterpTypes::NATCUBIC_LOG_DISCOUNT:
+    case InterpTypes::PCHIP_LOG_DISCOUNT:
+      return BasicInterpolator<CubicLog>{inter_type};
+    case InterpTypes::FINCUBIC_ZERO_RATES:
+    case InterpTypes::NATCUBIC_ZERO_RATES:
+    case InterpTypes::PCHIP_ZERO_RATES:
+      return BasicInterpolator<CubicZero>{inter_type};
   }
-  return ret;
+  throw std::runtime_error("Interpolation type not supported");
+}
+
+void Interpolator::fit(const std::vector<double>& times, const std::vector<double>& dfs){
+  std::visit([&](auto& interp) { interp.fit(times, dfs); }, impl_);
+}
+
+void Interpolator::set_last_value(double df){
+  std::visit([&](auto& interp) { interp.set_last_value(df); }, impl_);
+}
+
+void Interpolator::push_node(double t, double df){
+  std::visit([&](auto& interp) { interp.push_node(t, df); }, impl_);
+}
+
+void Interpolator::pop_node(){
+  std::visit([&](auto& interp) { interp.pop_node(); }, impl_);
+}
+
+void Interpolator::reserve(std::size_t num_points){
+  std::visit([&](auto& interp) { interp.reserve(num_points); }, impl_);
+}
+
+double Interpolator::interpolate(double t) const{
+  return std::visit([&](const auto& interp) { return interp.interpolate(t); }, impl_);
+}
+
+double Interpolator::interpolate(double t, std::size_t& hint) const{
+  return std::visit([&](const auto& interp) { return interp.interpolate(t, hint); }, impl_);
+}
+
+void Interpolator::interpolate(std::span<const double> ts, std::span<double> out) const{
+  std::visit([&](const auto& interp) { interp.interpolate(ts, out); }, impl_);
+}
+
+double Interpolator::forward(double t) const{
+  return std::visit([&](const auto& interp) { return interp.forward(t); }, impl_);
+}
+
+void Interpolator::forward(std::span<const double> ts, std::span<double> out) const{
+  std::visit([&](const auto& interp) { interp.forward(ts, out); }, impl_);
+}
+
+std::uint64_t Interpolator::version() const{
+  return std::visit([](const auto& interp) { return interp.version(); }, impl_);
+}
+
+const SegmentTable& Interpolator::table() const{
+  return std::visit([](const auto& interp) -> const SegmentTable& { return interp.table(); }, impl_);
+}
+
+double Interpolator::derivative(double t) const{
+  return std::visit([&](const auto& interp) { return interp.derivative(t); }, impl_);
+}
+
+void Interpolator::node_sensitivities(double t, std::span<double> out) const{
+  std::visit([&](const auto& interp) { interp.node_sensitivities(t, out); }, impl_);
 }
@@ -0,0 +1,23 @@
+#include <finproj/utils/UniformLookup.h>
+#include <stdexcept>
+
+UniformLookup::UniformLookup(double t_max, const std::vector<double>& dfs):t_max_{t_max}{
+  if (dfs.size() < 2)
+    throw std::runtime_error("Uniform lookup needs at least two grid points");
+  if (!(t_max > 0.0))
+    throw std::runtime_error("Uniform lookup needs a positive end time");
+  inv_step_ = static_cast<double>(dfs.size() - 1) / t_max;
+  cells_.reserve(dfs.size() - 1);
+  auto y1 = -log(dfs[0]);
+  for (size_t k{1}; k < dfs.size(); ++k) {
+    auto y2 = -log(dfs[k]);
+    cells_.push_back(Cell{y1, y2 - y1});
+    y1 = y2;
+  }
+}
+
+void UniformLookup::measure_error(std::span<const double> ts, std::span<const double> exact){
+  max_error_ = 0.0;
+  for (size_t k{0}; k < ts.size(); ++k)
+    max_error_ = fmax(max_error_, fabs(interpolate(ts[k]) / exact[k] - 1.0));
+}
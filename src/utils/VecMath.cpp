@@ -0,0 +1,302 @@
+#include <finproj/utils/VecMath.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define FINPROJ_HAVE_SIMD_KERNELS 1
+#endif
+
+namespace vecmath {
+namespace {
+
+enum class Op { EXP, EXP_NEG, LOG, EXPM1 };
+
+template <class T>
+T scalar(Op op, T x){
+  switch (op) {
+    case Op::EXP: return std::exp(x);
+    case Op::EXP_NEG: return std::exp(-x);
+    case Op::LOG: return std::log(x);
+    case Op::EXPM1: return std::expm1(x);
+  }
+  return x;
+}
+
+template <class T>
+void run_scalar(Op op, const T* x, T* y, std::size_t n){
+  for (std::size_t i{0}; i < n; ++i)
+    y[i] = scalar(op, x[i]);
+}
+
+#ifdef FINPROJ_HAVE_SIMD_KERNELS
+typedef double v4d __attribute__((vector_size(32)));
+typedef double v8d __attribute__((vector_size(64)));
+typedef float v8f __attribute__((vector_size(32)));
+typedef float v16f __attribute__((vector_size(64)));
+
+/** Constants of the kernels per element type. exp reduces x = k*ln2 + r with
+|r| <= ln2/2 and takes a Taylor polynomial of r, log writes x = 2^k * m with m in
+[sqrt(1/2), sqrt(2)) and sums 2*atanh((m - 1)/(m + 1)), expm1 uses its own Taylor
+series below |x| < 1/2 where exp(x) - 1 would cancel. */
+template <class T> struct Consts;
+
+template <> struct Consts<double> {
+  static constexpr double shifter = 6755399441055744.0; // 1.5 * 2^52
+  static constexpr double log2e = 1.4426950408889634;
+  static constexpr double ln2_hi = 6.93147180369123816490e-01;
+  static constexpr double ln2_lo = 1.90821492927058770002e-10;
+  static constexpr double exp_limit = 708.0;
+  static constexpr double min_normal = std::numeric_limits<double>::min();
+  static constexpr double max_finite = std::numeric_limits<double>::max();
+  static constexpr int mantissa_bits = 52;
+  static constexpr long bias = 1023;
+  static constexpr long mantissa_mask = 0x000fffffffffffffL;
+  static constexpr long one_bits = 0x3ff0000000000000L;
+  // 1/13!, ..., 1/2!, 1, 1
+  static constexpr double exp_poly[] = {1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0,
+                                        1.0 / 3628800.0, 1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0,
+                                        1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0};
+  // 1/23, 1/21, ..., 1/3, 1 in s^2
+  static constexpr double log_poly[] = {1.0 / 23.0, 1.0 / 21.0, 1.0 / 19.0, 1.0 / 17.0, 1.0 / 15.0,
+                                        1.0 / 13.0, 1.0 / 11.0, 1.0 / 9.0, 1.0 / 7.0, 1.0 / 5.0,
+                                        1.0 / 3.0, 1.0};
+  // 1/16!, ..., 1/2!, 1
+  static constexpr double expm1_poly[] = {1.0 / 20922789888000.0, 1.0 / 1307674368000.0,
+                                          1.0 / 87178291200.0, 1.0 / 6227020800.0, 1.0 / 479001600.0,
+                                          1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+                                          1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0,
+                                          1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0};
+};
+
+template <> struct Consts<float> {
+  static constexpr float shifter = 12582912.0f; // 1.5 * 2^23
+  static constexpr float log2e = 1.44269504f;
+  static constexpr float ln2_hi = 0.693359375f;
+  static constexpr float ln2_lo = -2.12194440e-4f;
+  static constexpr float exp_limit = 87.0f;
+  static constexpr float min_normal = std::numeric_limits<float>::min();
+  static constexpr float max_finite = std::numeric_limits<float>::max();
+  static constexpr int mantissa_bits = 23;
+  static constexpr int bias = 127;
+  static constexpr int mantissa_mask = 0x007fffff;
+  static constexpr int one_bits = 0x3f800000;
+  static constexpr float exp_poly[] = {1.0f / 5040.0f, 1.0f / 720.0f, 1.0f / 120.0f, 1.0f / 24.0f,
+                                       1.0f / 6.0f, 0.5f, 1.0f, 1.0f};
+  static constexpr float log_poly[] = {1.0f / 11.0f, 1.0f / 9.0f, 1.0f / 7.0f, 1.0f / 5.0f,
+                                       1.0f / 3.0f, 1.0f};
+  static constexpr float expm1_poly[] = {1.0f / 362880.0f, 1.0f / 40320.0f, 1.0f / 5040.0f,
+                                         1.0f / 720.0f, 1.0f / 120.0f, 1.0f / 24.0f, 1.0f / 6.0f,
+                                         0.5f, 1.0f};
+};
+
+template <class V>
+using Elem = std::remove_cvref_t<decltype(V{}[0])>;
+template <class V>
+using Mask = decltype(V{} < V{});
+
+/** The kernels are written once on GCC vector types and take their arguments by
+reference so that no vector crosses a call boundary. They are flattened into the
+target specific drivers below, which decides the instruction set. */
+template <class V, class T = Elem<V>>
+inline void poly(V& p, const V& x, const T* coeffs, std::size_t n){
+  p = V{} + coeffs[0];
+  for (std::size_t j{1}; j < n; ++j)
+    p = p * x + coeffs[j];
+}
+
+template <class V, class T = Elem<V>, class C = Consts<T>>
+inline void exp_kernel(V& x){
+  using I = Mask<V>;
+  const V shifter = V{} + C::shifter;
+  V k = x * C::log2e + shifter;
+  I ki = (I)k - (I)shifter;
+  k -= shifter;
+  V r = x - k * C::ln2_hi;
+  r = r - k * C::ln2_lo;
+  V p;
+  poly(p, r, C::exp_poly, std::size(C::exp_poly));
+  I scale = (ki + C::bias) << C::mantissa_bits;
+  x = p * (V)scale;
+}
+
+template <class V, class T = Elem<V>, class C = Consts<T>>
+inline void log_kernel(V& x){
+  using I = Mask<V>;
+  I bits = (I)x;
+  I e = (bits >> C::mantissa_bits) - C::bias;
+  V m = (V)((bits & C::mantissa_mask) | C::one_bits);
+  I big = m > static_cast<T>(1.41421356237309504880);
+  m = big ? m * static_cast<T>(0.5) : m;
+  e = big ? e + 1 : e;
+  // exact int to float through the shifter, |e| is far below 2^22
+  const V shifter = V{} + C::shifter;
+  V k = (V)((I)shifter + e) - shifter;
+  V s = (m - static_cast<T>(1)) / (m + static_cast<T>(1));
+  V s2 = s * s;
+  V p;
+  poly(p, s2, C::log_poly, std::size(C::log_poly));
+  x = k * C::ln2_hi + (k * C::ln2_lo + static_cast<T>(2) * s * p);
+}
+
+template <class V, class T = Elem<V>, class C = Consts<T>>
+inline void expm1_kernel(V& x){
+  V e = x;
+  exp_kernel(e);
+  V p;
+  poly(p, x, C::expm1_poly, std::size(C::expm1_poly));
+  V a = x < V{} ? -x : x;
+  x = a < static_cast<T>(0.5) ? x * p : e - static_cast<T>(1);
+}
+
+template <Op op, class V, class T = Elem<V>, class C = Consts<T>>
+inline void out_of_range(const V& x, Mask<V>& bad){
+  if constexpr (op == Op::LOG) {
+    bad = !(x >= C::min_normal && x <= C::max_finite);
+  } else {
+    V a = x < V{} ? -x : x;
+    bad = !(a <= C::exp_limit);
+  }
+}
+
+template <Op op, class V>
+inline void kernel(V& x){
+  if constexpr (op == Op::EXP || op == Op::EXP_NEG)
+    exp_kernel(x);
+  else if constexpr (op == Op::LOG)
+    log_kernel(x);
+  else
+    expm1_kernel(x);
+}
+
+__attribute__((target("avx"))) inline bool any(const Mask<v4d>& m){
+  return _mm256_movemask_pd((__m256d)m) != 0;
+}
+__attribute__((target("avx"))) inline bool any(const Mask<v8f>& m){
+  return _mm256_movemask_ps((__m256)m) != 0;
+}
+__attribute__((target("avx512f"))) inline bool any(const Mask<v8d>& m){
+  return _mm512_test_epi64_mask((__m512i)m, (__m512i)m) != 0;
+}
+__attribute__((target("avx512f"))) inline bool any(const Mask<v16f>& m){
+  return _mm512_test_epi32_mask((__m512i)m, (__m512i)m) != 0;
+}
+
+/** Runs op over x in blocks of one vector. A block with any lane out of range goes
+to <cmath>, the tail is padded with 1 and computed in a vector as well. */
+template <Op op, class V, class T = Elem<V>>
+inline void run_block(const T* x, T* y, std::size_t len){
+  V v;
+  if (len == sizeof(V) / sizeof(T)) {
+    std::memcpy(&v, x, sizeof(V));
+  } else {
+    v = V{} + static_cast<T>(1);
+    std::memcpy(&v, x, len * sizeof(T));
+  }
+  if constexpr (op == Op::EXP_NEG)
+    v = -v;
+  Mask<V> bad;
+  out_of_range<op>(v, bad);
+  if (any(bad)) {
+    for (std::size_t j{0}; j < len; ++j)
+      y[j] = scalar(op, x[j]);
+    return;
+  }
+  kernel<op>(v);
+  if (len == sizeof(V) / sizeof(T))
+    std::memcpy(y, &v, sizeof(V));
+  else
+    std::memcpy(y, &v, len * sizeof(T));
+}
+
+template <Op op, class V, class T = Elem<V>>
+inline void run_vector(const T* x, T* y, std::size_t n){
+  constexpr auto width = sizeof(V) / sizeof(T);
+  std::size_t i{0};
+  for (; i + width <= n; i += width)
+    run_block<op, V>(x + i, y + i, width);
+  if (i < n)
+    run_block<op, V>(x + i, y + i, n - i);
+}
+
+template <class V, class T = Elem<V>>
+inline void dispatch_op(Op op, const T* x, T* y, std::size_t n){
+  switch (op) {
+    case Op::EXP: run_vector<Op::EXP, V>(x, y, n); break;
+    case Op::EXP_NEG: run_vector<Op::EXP_NEG, V>(x, y, n); break;
+    case Op::LOG: run_vector<Op::LOG, V>(x, y, n); break;
+    case Op::EXPM1: run_vector<Op::EXPM1, V>(x, y, n); break;
+  }
+}
+
+__attribute__((target("avx2,fma"), flatten)) void run_avx2(Op op, const double* x, double* y, std::size_t n){
+  dispatch_op<v4d>(op, x, y, n);
+}
+__attribute__((target("avx2,fma"), flatten)) void run_avx2(Op op, const float* x, float* y, std::size_t n){
+  dispatch_op<v8f>(op, x, y, n);
+}
+__attribute__((target("avx512f"), flatten)) void run_avx512(Op op, const double* x, double* y, std::size_t n){
+  dispatch_op<v8d>(op, x, y, n);
+}
+__attribute__((target("avx512f"), flatten)) void run_avx512(Op op, const float* x, float* y, std::size_t n){
+  dispatch_op<v16f>(op, x, y, n);
+}
+#endif
+
+Isa detect_isa(){
+  /** FINPROJ_VECMATH=scalar|avx2 caps the choice, for benchmarks and for testing the
+  narrower kernels on a wider machine. */
+  auto cap = Isa::AVX512;
+  if (const char* env = std::getenv("FINPROJ_VECMATH")) {
+    std::string_view name{env};
+    if (name == "scalar")
+      cap = Isa::SCALAR;
+    else if (name == "avx2")
+      cap = Isa::AVX2;
+  }
+#ifdef FINPROJ_HAVE_SIMD_KERNELS
+  if (cap == Isa::AVX512 && __builtin_cpu_supports("avx512f"))
+    return Isa::AVX512;
+  if (cap != Isa::SCALAR && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return Isa::AVX2;
+#endif
+  return Isa::SCALAR;
+}
+
+template <class T>
+void run(Op op, std::span<const T> x, std::span<T> y){
+  if (x.size() != y.size())
+    throw std::runtime_error("Input and output have different lengths");
+  switch (active_isa()) {
+#ifdef FINPROJ_HAVE_SIMD_KERNELS
+    case Isa::AVX512:
+      run_avx512(op, x.data(), y.data(), x.size());
+      return;
+    case Isa::AVX2:
+      run_avx2(op, x.data(), y.data(), x.size());
+      return;
+#endif
+    default:
+      run_scalar(op, x.data(), y.data(), x.size());
+  }
+}
+
+}// namespace
+
+Isa active_isa(){
+  static const Isa isa = detect_isa();
+  return isa;
+}
+
+void exp(std::span<const double> x, std::span<double> y){ run(Op::EXP, x, y); }
+void log(std::span<const double> x, std::span<double> y){ run(Op::LOG, x, y); }
+void expm1(std::span<const double> x, std::span<double> y){ run(Op::EXPM1, x, y); }
+void exp(std::span<const float> x, std::span<float> y){ run(Op::EXP, x, y); }
+void log(std::span<const float> x, std::span<float> y){ run(Op::LOG, x, y); }
+void expm1(std::span<const float> x, std::span<float> y){ run(Op::EXPM1, x, y); }
+void exp_neg(std::span<double> x){ run(Op::EXP_NEG, std::span<const double>{x}, x); }
+
+}// namespace vecmath
@@ -8,6 +8,7 @@
 #include <finproj/utils/Misc.h>
 #include <finproj/curves/CDSIndexPortfolio.h>
 #include <finproj/curves/CDSBasket.h>
+#include <finproj/models/GaussCopula.h>
 #include <tuple>
 #include <iostream>
 #include <fstream>
@@ -132,3 +133,44 @@ TEST_CASE( "test_cds_basket", "[single-file]" ){
 
 
 }
+
+TEST_CASE( "test_cds_basket_uniform_discounting", "[single-file]" ){
+  ChronoDate valuation_date{2007,8,1};
+  auto settlement_date = valuation_date.add_weekdays(1);
+  auto dc_type = DayCountTypes::THIRTY_E_360_ISDA;
+  std::vector<IborDeposit> depos{IborDeposit(settlement_date, "1D", 0.0502, dc_type)};
+  std::vector<IborFRA> fras{};
+  std::vector<IborSwap> swaps{};
+  for (auto [tenor, rate] : std::vector<std::pair<std::string, double>>{{"1Y", 0.0502}, {"2Y", 0.0495}, {"3Y", 0.0510},
+                                                                         {"5Y", 0.0525}, {"7Y", 0.0540}})
+    swaps.emplace_back(IborSwap(settlement_date, std::string{tenor}, SwapTypes::PAY, rate, FrequencyTypes::SEMI_ANNUAL, dc_type));
+  auto libor_curve = IborSingleCurve(valuation_date, depos, fras, swaps);
+
+  std::vector<CreditCurve> issuer_curves{};
+  for (int i{0}; i < 5; ++i) {
+    std::vector<CDS> contracts{};
+    for (int years : {3, 5, 7})
+      contracts.emplace_back(CDS(valuation_date, valuation_date.next_cds_date(12 * years), 0.004 + 0.002 * i + 0.0005 * years));
+    issuer_curves.emplace_back(CreditCurve(valuation_date, "C" + std::to_string(i), contracts, libor_curve, 0.4));
+  }
+  ChronoDate maturity_date{2011,12,20};
+  auto basket = CDSBasket(valuation_date, maturity_date);
+  auto default_times = GaussCopula::default_times_gc(issuer_curves, corr_matrix_generator(0.0625, 5), 20000, 42, "PSEUDO");
+
+  /** the lookup moves each default time df by at most its max_error() relative */
+  auto tmat = (maturity_date - valuation_date) / 365.0;
+  auto max_error = libor_curve.uniform_lookup(tmat, CDSBasket::daily_grid_points(tmat)).max_error();
+  REQUIRE(max_error > 0.0);
+  for (int ntd{1}; ntd <= 3; ++ntd) {
+    auto [rpv01, prot] = basket.value_legs_mc(valuation_date, ntd, default_times, issuer_curves, libor_curve);
+    auto [uniform_rpv01, uniform_prot] = basket.value_legs_mc(valuation_date, ntd, default_times, issuer_curves,
+                                                              libor_curve, true);
+    REQUIRE(uniform_rpv01 == rpv01);
+    REQUIRE(prot > 0.0);
+    REQUIRE_THAT(uniform_prot, Catch::Matchers::WithinAbs(prot, max_error * prot));
+  }
+
+  /** a basket valued on its maturity date has nothing left to discount */
+  auto [rpv01, prot] = basket.value_legs_mc(maturity_date, 1, default_times, issuer_curves, libor_curve, true);
+  REQUIRE(prot == 0.0);
+}
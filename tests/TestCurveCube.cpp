@@ -0,0 +1,58 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <finproj/curves/CurveCube.h>
+#include <finproj/curves/DiscountCurveZeros.h>
+#include <cmath>
+#include <vector>
+
+TEST_CASE( "test_curve_cube", "[single-file]" ){
+  ChronoDate start_date{2018,1,1};
+  std::vector<ChronoDate> dates{};
+  for (int i{1}; i < 11; ++i)
+    dates.push_back(start_date.add_years(1.5 * i));
+  const Eigen::Index num_scenarios = 7;
+  Eigen::MatrixXd zero_rates(num_scenarios, static_cast<Eigen::Index>(dates.size()));
+  for (Eigen::Index s{0}; s < num_scenarios; ++s)
+    for (Eigen::Index j{0}; j < zero_rates.cols(); ++j)
+      zero_rates(s, j) = 0.02 + 0.003 * s + 0.002 * j - 0.0001 * j * j;
+
+  std::vector<double> ts{};
+  for (double t{0.0}; t < 20.0; t += 0.23)
+    ts.push_back(t);
+
+  for (auto freq_type : {FrequencyTypes::ANNUAL, FrequencyTypes::CONTINUOUS, FrequencyTypes::SIMPLE}) {
+    for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::LINEAR_ZERO_RATES}) {
+      CurveCube cube{start_date, dates, zero_rates, freq_type, DayCountTypes::ACT_ACT_ISDA, interp_type};
+      REQUIRE(cube.num_scenarios() == num_scenarios);
+      REQUIRE(cube.num_nodes() == static_cast<Eigen::Index>(dates.size()));
+      auto dfs = cube.df(ts);
+      for (Eigen::Index s{0}; s < num_scenarios; ++s) {
+        std::vector<double> row(zero_rates.row(s).begin(), zero_rates.row(s).end());
+        DiscountCuveZeros curve{start_date, dates, row, freq_type, DayCountTypes::ACT_ACT_ISDA, interp_type};
+        for (std::size_t k{0}; k < ts.size(); ++k) {
+          auto expected = curve.df(ts[k]);
+          REQUIRE_THAT(dfs(s, static_cast<Eigen::Index>(k)), Catch::Matchers::WithinRel(expected, 1e-13));
+          REQUIRE_THAT(cube.df(s, ts[k]), Catch::Matchers::WithinRel(expected, 1e-13));
+        }
+      }
+    }
+  }
+
+  CurveCube cube{start_date, dates, zero_rates};
+  std::vector<double> pay_times{0.5, 1.0, 1.5, 2.0, 7.25};
+  std::vector<double> amounts{2.5, 2.5, 2.5, 2.5, 102.5};
+  auto pvs = cube.pv(pay_times, amounts);
+  REQUIRE(pvs.size() == num_scenarios);
+  for (Eigen::Index s{0}; s < num_scenarios; ++s) {
+    auto pv = 0.0;
+    for (std::size_t k{0}; k < pay_times.size(); ++k)
+      pv += amounts[k] * cube.df(s, pay_times[k]);
+    REQUIRE_THAT(pvs(s), Catch::Matchers::WithinRel(pv, 1e-13));
+  }
+  /** rates rise with the scenario index, so values fall */
+  REQUIRE(pvs(0) > pvs(num_scenarios - 1));
+
+  REQUIRE_THROWS_AS(CurveCube(std::vector<double>{1.0, 2.0}, Eigen::MatrixXd::Zero(3, 3)), std::runtime_error);
+  REQUIRE_THROWS_AS(CurveCube(std::vector<double>{1.0, 2.0}, Eigen::MatrixXd::Zero(3, 2), FrequencyTypes::ANNUAL,
+                              InterpTypes::NATCUBIC_LOG_DISCOUNT), std::runtime_error);
+}
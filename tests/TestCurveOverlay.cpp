@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <finproj/curves/CDS.h>
+#include <finproj/curves/CurveOverlay.h>
+#include <finproj/curves/IborSingleCurve.h>
+#include <cmath>
+#include <tuple>
+#include <vector>
+#include "TestCurves.h"
+
+TEST_CASE( "test_zero_shift", "[single-file]" ){
+  std::vector<double> pillars{1.0, 2.0, 5.0, 10.0};
+  auto shifts = ZeroShift::key_rates(pillars, 0.0001);
+  REQUIRE(shifts.size() == pillars.size());
+  for (double t{0.0}; t < 15.0; t += 0.25) {
+    auto total = 0.0;
+    for (const auto& shift : shifts)
+      total += shift(t);
+    REQUIRE_THAT(total, Catch::Matchers::WithinAbs(0.0001, 1e-18));
+  }
+  REQUIRE(shifts[0](0.5) == 0.0001);
+  REQUIRE(shifts[1](1.0) == 0.0);
+  REQUIRE(shifts[1](2.0) == 0.0001);
+  REQUIRE_THAT(shifts[2](3.5), Catch::Matchers::WithinAbs(0.00005, 1e-18));
+  REQUIRE(shifts[2](12.0) == 0.0);
+  REQUIRE(shifts[3](12.0) == 0.0001);
+  REQUIRE(ZeroShift::parallel(0.01)(7.0) == 0.01);
+  REQUIRE(ZeroShift{}(7.0) == 0.0);
+}
+
+TEST_CASE( "test_curve_overlays", "[single-file]" ){
+  ChronoDate curve_date{2018,12,20};
+  auto [libor_curve, issuer_curve] = swap_and_cds_curves(curve_date);
+
+  std::vector<double> ts{};
+  for (double t{0.0}; t < 12.0; t += 0.37)
+    ts.push_back(t);
+  std::vector<double> out(ts.size());
+
+  auto flat = DiscountCurveOverlay(libor_curve, ZeroShift{});
+  auto up = DiscountCurveOverlay::parallel(libor_curve, 0.0001);
+  up.df(ts, out);
+  for (std::size_t i{0}; i < ts.size(); ++i) {
+    REQUIRE(flat.df(ts[i]) == libor_curve.df(ts[i]));
+    REQUIRE_THAT(up.df(ts[i]), Catch::Matchers::WithinRel(libor_curve.df(ts[i]) * std::exp(-0.0001 * ts[i]), 1e-15));
+    REQUIRE_THAT(out[i], Catch::Matchers::WithinRel(up.df(ts[i]), 1e-15));
+  }
+  auto date = curve_date.add_months(40);
+  REQUIRE(flat.df(date) == libor_curve.df(date));
+
+  /** the key rate buckets add up to the parallel shift */
+  auto buckets = DiscountCurveOverlay::key_rates(libor_curve, 0.0001);
+  REQUIRE(buckets.size() + 1 == libor_curve.times_.size());
+  for (auto t : ts) {
+    auto product = libor_curve.df(t);
+    for (const auto& bucket : buckets)
+      product *= bucket.df(t) / libor_curve.df(t);
+    REQUIRE_THAT(product, Catch::Matchers::WithinRel(up.df(t), 1e-12));
+  }
+
+  /** an unshifted overlay prices a CDS exactly like its base curve */
+  auto cds = CDS(curve_date, curve_date.add_months(60), 0.009);
+  auto base_value = cds.value(curve_date, issuer_curve, 0.4);
+  auto overlay_value = cds.value(curve_date, CreditCurveOverlay(issuer_curve, ZeroShift{}), 0.4);
+  REQUIRE(std::get<0>(overlay_value) == std::get<0>(base_value));
+  REQUIRE(std::get<1>(overlay_value) == std::get<1>(base_value));
+
+  /** a spread shift moves the par spread by about the bump, as a rebuilt curve does */
+  auto bump = 0.0001;
+  auto base_spread = cds.par_spread(curve_date, issuer_curve, 0.4);
+  auto shifted = CreditCurveOverlay::spread_shift(issuer_curve, bump);
+  auto shifted_spread = cds.par_spread(curve_date, shifted, 0.4);
+  REQUIRE_THAT(shifted_spread - base_spread, Catch::Matchers::WithinRel(bump, 0.05));
+  REQUIRE(shifted.surv_prob(date) < issuer_curve.surv_prob(date));
+
+  auto cs01 = 0.0;
+  for (const auto& bucket : CreditCurveOverlay::key_rates(issuer_curve, bump / 0.6))
+    cs01 += std::get<0>(cds.value(curve_date, bucket, 0.4)) - std::get<0>(base_value);
+  auto parallel_cs01 = std::get<0>(cds.value(curve_date, shifted, 0.4)) - std::get<0>(base_value);
+  REQUIRE_THAT(cs01, Catch::Matchers::WithinRel(parallel_cs01, 0.01));
+}
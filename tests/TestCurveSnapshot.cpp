@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <finproj/curves/CDS.h>
+#include <finproj/curves/CreditCurve.h>
+#include <finproj/curves/CurveSnapshot.h>
+#include <finproj/curves/IborSingleCurve.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "TestCurves.h"
+
+TEST_CASE( "test_curve_snapshot", "[single-file]" ){
+  ChronoDate curve_date{2018,12,20};
+  auto swaps = annual_swaps(curve_date);
+  auto cds_contracts = annual_cds_contracts(curve_date);
+  auto [libor_curve, issuer_curve] = swap_and_cds_curves(curve_date);
+
+  std::vector<ChronoDate> df_dates{};
+  std::vector<double> df_values{};
+  for (int i{1}; i < 8; ++i) {
+    df_dates.push_back(curve_date.add_months(6 * i * i));
+    df_values.push_back(std::exp(-0.03 * i * i / 2.0 - 0.002 * i));
+  }
+  std::vector<InterpTypes> interp_types{InterpTypes::FLAT_FWD_RATES, InterpTypes::LINEAR_ZERO_RATES,
+                                        InterpTypes::LINEAR_FWD_RATES, InterpTypes::NATCUBIC_LOG_DISCOUNT,
+                                        InterpTypes::PCHIP_ZERO_RATES};
+  std::vector<DiscountCurve> curves{};
+  CurveSnapshotWriter writer{};
+  writer.add(libor_curve, "libor");
+  writer.add(issuer_curve);
+  for (auto interp_type : interp_types) {
+    curves.emplace_back(curve_date, df_dates, df_values, interp_type);
+    writer.add(curves.back(), "curve");
+  }
+  auto path = (std::filesystem::temp_directory_path() / "finproj_test_curves.snap").string();
+  writer.write(path);
+
+  CurveSnapshot snapshot(path);
+  REQUIRE(snapshot.size() == 2 + interp_types.size());
+  REQUIRE(snapshot.find(CurveView::Kind::SURVIVAL, "ABC") == nullptr);
+
+  std::vector<ChronoDate> dates{};
+  std::vector<double> ts{};
+  for (int m{0}; m < 400; m += 7) {
+    dates.push_back(curve_date.add_months(m));
+    ts.push_back(m / 12.0 + 0.013);
+  }
+  std::vector<double> batch(ts.size());
+
+  const auto* libor_view = snapshot.find(CurveView::Kind::DISCOUNT, "libor");
+  REQUIRE(libor_view != nullptr);
+  REQUIRE(libor_view->valuation_date() == curve_date);
+  IborSingleCurve restored_libor(*libor_view);
+  for (const auto& date : dates) {
+    REQUIRE(libor_view->value(date) == libor_curve.df(date));
+    REQUIRE(restored_libor.df(date) == libor_curve.df(date));
+  }
+  /** the float legs project in the curve's day count, so the swaps price the same */
+  REQUIRE(restored_libor.day_count_type_ == libor_curve.day_count_type_);
+  REQUIRE(restored_libor.freq_type_ == libor_curve.freq_type_);
+  for (const auto& swap : swaps)
+    REQUIRE(swap.pv(curve_date, restored_libor) == swap.pv(curve_date, libor_curve));
+
+  const auto* issuer_view = snapshot.find(CurveView::Kind::SURVIVAL, "XYZ");
+  REQUIRE(issuer_view != nullptr);
+  REQUIRE(issuer_view->recovery_rate() == 0.4);
+  CreditCurve restored_issuer(*issuer_view, restored_libor, cds_contracts);
+  for (const auto& date : dates) {
+    REQUIRE(issuer_view->value(date) == issuer_curve.surv_prob(date));
+    REQUIRE(restored_issuer.surv_prob(date) == issuer_curve.surv_prob(date));
+  }
+  auto bumped = issuer_curve.get_bumped_spread_curve(1.0);
+  auto restored_bumped = restored_issuer.get_bumped_spread_curve(1.0);
+  REQUIRE_THAT(restored_bumped.values_.back(), Catch::Matchers::WithinAbs(bumped.values_.back(), 1e-12));
+
+  for (std::size_t k{0}; k < interp_types.size(); ++k) {
+    const auto& view = snapshot[2 + k];
+    REQUIRE(view.interp_type() == interp_types[k]);
+    view.value(ts, batch);
+    for (std::size_t i{0}; i < ts.size(); ++i) {
+      REQUIRE(view.value(ts[i]) == curves[k].df(ts[i]));
+      REQUIRE_THAT(batch[i], Catch::Matchers::WithinULP(view.value(ts[i]), 2));
+    }
+    DiscountCurve restored(view);
+    for (auto t : ts)
+      REQUIRE(restored.df(t) == curves[k].df(t));
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_CASE( "test_curve_snapshot_rejects_bad_files", "[single-file]" ){
+  ChronoDate curve_date{2018,12,20};
+  DiscountCurve curve(curve_date, {curve_date.add_years(1), curve_date.add_years(5)}, {0.97, 0.85});
+  CurveSnapshotWriter writer{};
+  writer.add(curve, "curve");
+  auto path = (std::filesystem::temp_directory_path() / "finproj_test_bad_curves.snap").string();
+  writer.write(path);
+
+  std::vector<char> bytes(std::filesystem::file_size(path));
+  std::ifstream(path, std::ios::binary).read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  auto rewrite = [&](std::vector<char> contents) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  };
+
+  REQUIRE_THROWS_AS(CurveSnapshot(path + ".missing"), std::runtime_error);
+  rewrite({bytes.begin(), bytes.end() - 8});
+  REQUIRE_THROWS_AS(CurveSnapshot(path), std::runtime_error);
+  auto bad_magic = bytes;
+  bad_magic[0] = 'X';
+  rewrite(bad_magic);
+  REQUIRE_THROWS_AS(CurveSnapshot(path), std::runtime_error);
+  auto bad_version = bytes;
+  bad_version[8] = static_cast<char>(CurveSnapshot::format_version + 1);
+  rewrite(bad_version);
+  REQUIRE_THROWS_AS(CurveSnapshot(path), std::runtime_error);
+  auto bad_offset = bytes;
+  bad_offset[32 + 24 + 6] = 1; // times offset far beyond the end of the file
+  rewrite(bad_offset);
+  REQUIRE_THROWS_AS(CurveSnapshot(path), std::runtime_error);
+  auto bad_day_count = bytes;
+  bad_day_count[32 + 60] = 0x7f; // day count type in the low half of the conventions
+  rewrite(bad_day_count);
+  REQUIRE_THROWS_AS(CurveSnapshot(path), std::runtime_error);
+  auto bad_freq = bytes;
+  bad_freq[32 + 62] = 0x7f; // frequency type in the high half
+  rewrite(bad_freq);
+  REQUIRE_THROWS_AS(CurveSnapshot(path), std::runtime_error);
+  rewrite(bytes);
+  REQUIRE(CurveSnapshot(path)[0].value(1.0) == curve.df(1.0));
+  std::filesystem::remove(path);
+}
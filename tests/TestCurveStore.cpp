@@ -0,0 +1,54 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <finproj/curves/CurveStore.h>
+#include <finproj/curves/DiscountCurve.h>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "TestCurves.h"
+
+TEST_CASE( "test_curve_store", "[single-file]" ){
+  ChronoDate valuation_date{2018,12,20};
+  CurveStore<DiscountCurve> store{};
+  REQUIRE(!store.snapshot());
+  REQUIRE(store.version() == 0);
+  REQUIRE_THROWS_AS(store.update([](DiscountCurve curve) { return curve; }), std::runtime_error);
+
+  REQUIRE(store.publish(flat_curve(valuation_date, 1)) == 1);
+  auto pinned = store.snapshot();
+  REQUIRE(pinned.version() == 1);
+  REQUIRE(pinned->frozen());
+
+  const std::uint64_t num_versions = 300;
+  std::atomic<bool> done{false};
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> readers{};
+  for (int r{0}; r < 3; ++r) {
+    readers.emplace_back([&] {
+      std::uint64_t last_seen{0};
+      while (!done.load()) {
+        auto snapshot = store.snapshot();
+        auto expected = std::exp(-0.0001 * static_cast<double>(snapshot.version()) * 5.0);
+        if (std::fabs(snapshot->df(5.0) - expected) > 1e-14 || snapshot.version() < last_seen)
+          ++mismatches;
+        last_seen = snapshot.version();
+      }
+    });
+  }
+  for (std::uint64_t v{2}; v <= num_versions; ++v) {
+    if (v % 2 == 0)
+      REQUIRE(store.publish(flat_curve(valuation_date, v)) == v);
+    else
+      REQUIRE(store.update([&](DiscountCurve) { return flat_curve(valuation_date, v); }) == v);
+  }
+  done = true;
+  for (auto& reader : readers)
+    reader.join();
+
+  REQUIRE(mismatches == 0);
+  REQUIRE(store.version() == num_versions);
+  /** a pinned snapshot outlives later publications unchanged */
+  REQUIRE(pinned.version() == 1);
+  REQUIRE_THAT(pinned->df(5.0), Catch::Matchers::WithinAbs(std::exp(-0.0005), 1e-14));
+}
@@ -0,0 +1,51 @@
+#ifndef FINPROJ_TESTS_TESTCURVES_H_
+#define FINPROJ_TESTS_TESTCURVES_H_
+#include <finproj/curves/CDS.h>
+#include <finproj/curves/CreditCurve.h>
+#include <finproj/curves/DiscountCurve.h>
+#include <finproj/curves/IborSingleCurve.h>
+#include <finproj/utils/ChronoDate.h>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/** Flat curve at a rate of 0.0001 * version, which encodes the version or generation it
+is published as, so a reader can check that a curve and its version belong together. */
+inline DiscountCurve flat_curve(const ChronoDate& valuation_date, std::uint64_t version){
+  auto rate = 0.0001 * static_cast<double>(version);
+  std::vector<ChronoDate> dates{valuation_date.add_years(1), valuation_date.add_years(10)};
+  return {valuation_date, dates, {std::exp(-rate * (dates[0] - valuation_date) / 365.0),
+                                  std::exp(-rate * (dates[1] - valuation_date) / 365.0)}};
+}
+
+struct SwapAndCDSCurves {
+  IborSingleCurve libor_curve;
+  CreditCurve issuer_curve;
+};
+
+/** 5% semi-annual payer swaps maturing every year from 1y to 10y. */
+inline std::vector<IborSwap> annual_swaps(const ChronoDate& curve_date){
+  std::vector<IborSwap> swaps{};
+  for (int i{1}; i < 11; ++i)
+    swaps.emplace_back(IborSwap(curve_date, curve_date.add_months(12 * i), SwapTypes::PAY, 0.05,
+                                FrequencyTypes::SEMI_ANNUAL, DayCountTypes::ACT_365F));
+  return swaps;
+}
+
+/** CDS with the maturities of annual_swaps and spreads rising from 50bp by 10bp a year. */
+inline std::vector<CDS> annual_cds_contracts(const ChronoDate& curve_date){
+  std::vector<CDS> cds_contracts{};
+  for (int i{1}; i < 11; ++i)
+    cds_contracts.emplace_back(CDS(curve_date, curve_date.add_months(12 * i), 0.005 + 0.001 * (i - 1)));
+  return cds_contracts;
+}
+
+/** Libor curve bootstrapped from annual_swaps and an "XYZ" issuer curve with 40% recovery
+from annual_cds_contracts. */
+inline SwapAndCDSCurves swap_and_cds_curves(const ChronoDate& curve_date){
+  auto libor_curve = IborSingleCurve(curve_date, {}, {}, annual_swaps(curve_date));
+  auto issuer_curve = CreditCurve(curve_date, "XYZ", annual_cds_contracts(curve_date), libor_curve, 0.4);
+  return {std::move(libor_curve), std::move(issuer_curve)};
+}
+
+#endif//FINPROJ_TESTS_TESTCURVES_H_
@@ -5,6 +5,7 @@
 #include <finproj/utils/Misc.h>
 #include <finproj/curves/DiscountCurveZeros.h>
 #include <algorithm>
+#include <cmath>
 
 TEST_CASE( "test_FinDiscountCurveZeros", "[single-file]" ){
   ChronoDate start_date(2018,1,1);
@@ -47,4 +48,140 @@ TEST_CASE( "test_FinDiscountCurveZeros", "[single-file]" ){
 
 
 
+}
+
+TEST_CASE( "test_zero_df_round_trip", "[single-file]" ){
+  ChronoDate start_date(2018,1,1);
+  DiscountCurve curve{start_date};
+  auto times = linspace(0.5, 30.0, 13);
+  auto rates = linspace(0.0001, 0.08, 13);
+  for (auto freq_type : {FrequencyTypes::CONTINUOUS, FrequencyTypes::SIMPLE, FrequencyTypes::ANNUAL,
+                         FrequencyTypes::SEMI_ANNUAL, FrequencyTypes::QUARTERLY, FrequencyTypes::MONTHLY}) {
+    auto dfs = curve.zero_to_df(rates, times, freq_type);
+    auto f = static_cast<int>(freq_type);
+    for (size_t i = 0; i < times.size(); ++i) {
+      auto expected = freq_type == FrequencyTypes::CONTINUOUS ? std::exp(-rates[i] * times[i])
+                    : freq_type == FrequencyTypes::SIMPLE ? 1.0 / (1.0 + rates[i] * times[i])
+                    : std::pow(1.0 + rates[i] / f, -f * times[i]);
+      REQUIRE_THAT(dfs[i], Catch::Matchers::WithinRel(expected, 1e-13));
+    }
+    auto zeros = curve.df_to_zero(dfs, times, freq_type);
+    for (size_t i = 0; i < times.size(); ++i)
+      REQUIRE_THAT(zeros[i], Catch::Matchers::WithinRel(rates[i], 1e-11));
+  }
+}
+
+TEST_CASE( "test_df_cache", "[single-file]" ){
+  ChronoDate start_date(2018,1,1);
+  std::vector<ChronoDate> dates{};
+  std::vector<double> dfs{};
+  for (int i = 1; i <= 10; ++i) {
+    dates.push_back(start_date.add_years(i));
+    dfs.push_back(std::exp(-0.03 * i - 0.001 * i * i));
+  }
+  DiscountCurve plain{start_date, dates, dfs};
+  DiscountCurve cached{start_date, dates, dfs};
+  cached.enable_df_cache();
+  auto check = [&]() {
+    for (auto day_count_type : {DayCountTypes::ACT_ACT_ISDA, DayCountTypes::ACT_360, DayCountTypes::THIRTY_E_360})
+      for (int m = 0; m < 130; m += 7) {
+        auto dt = start_date.add_months(m);
+        REQUIRE(cached.df(dt, day_count_type) == plain.df(dt, day_count_type));
+        REQUIRE(cached.df(dt, day_count_type) == plain.df(dt, day_count_type));
+      }
+  };
+  check();
+
+  // refitting the nodes invalidates the cached discount factors
+  plain.interpolator_.set_last_value(plain.dfs_.back() * 0.99);
+  cached.interpolator_.set_last_value(cached.dfs_.back() * 0.99);
+  check();
+
+  cached.freeze();
+  REQUIRE(cached.frozen());
+  check();
+  plain.interpolator_.pop_node();
+  cached.interpolator_.pop_node();
+  check();
+}
+
+TEST_CASE( "test_span_queries", "[single-file]" ){
+  ChronoDate start_date(2018,1,1);
+  std::vector<ChronoDate> dates{};
+  std::vector<double> dfs{};
+  for (int i = 1; i <= 10; ++i) {
+    dates.push_back(start_date.add_years(i));
+    dfs.push_back(std::exp(-0.03 * i - 0.001 * i * i));
+  }
+  const DiscountCurve curve{start_date, dates, dfs};
+  std::vector<ChronoDate> query{};
+  for (int m = 1; m < 150; m += 5)
+    query.push_back(start_date.add_months(m));
+  std::vector<double> out(query.size()), times(query.size());
+
+  curve.times(query, times);
+  curve.df(query, out);
+  auto expected = curve.df(query);
+  for (size_t i = 0; i < query.size(); ++i) {
+    REQUIRE(out[i] == expected[i]);
+    REQUIRE_THAT(out[i], Catch::Matchers::WithinULP(curve.df(query[i]), 2));
+  }
+  curve.df(times, out);
+  for (size_t i = 0; i < query.size(); ++i)
+    REQUIRE(out[i] == expected[i]);
+
+  for (auto day_count_type : {DayCountTypes::ACT_ACT_ISDA, DayCountTypes::ACT_360}) {
+    curve.zero_rates(query, out, FrequencyTypes::QUARTERLY, day_count_type);
+    expected = curve.df_to_zero(curve.df(query), query, FrequencyTypes::QUARTERLY, day_count_type);
+    for (size_t i = 0; i < query.size(); ++i)
+      REQUIRE_THAT(out[i], Catch::Matchers::WithinRel(expected[i], 1e-14));
+  }
+  curve.cc_rates(query, out);
+  expected = curve.cc_rates(query);
+  for (size_t i = 0; i < query.size(); ++i)
+    REQUIRE(out[i] == expected[i]);
+
+  curve.fwd(query, out);
+  expected = curve.fwd(times);
+  for (size_t i = 0; i < query.size(); ++i)
+    REQUIRE(out[i] == expected[i]);
+  REQUIRE_THROWS(curve.df(query, std::span(out).first(3)));
+}
+
+TEST_CASE( "test_swap_rate_strip", "[single-file]" ){
+  ChronoDate start_date(2018,1,31);
+  std::vector<ChronoDate> dates{};
+  std::vector<double> dfs{};
+  for (int i = 1; i <= 31; ++i) {
+    dates.push_back(start_date.add_years(i));
+    dfs.push_back(std::exp(-0.02 * i - 0.0005 * i * i));
+  }
+  DiscountCurve curve{start_date, dates, dfs};
+  auto effective_date = start_date.add_days(2);
+  // whole years from the effective date sit on the long schedule, the others do not
+  std::vector<ChronoDate> maturities{};
+  for (int i = 1; i <= 30; ++i)
+    maturities.push_back(effective_date.add_years(i));
+  maturities.push_back(effective_date.add_months(18));
+  maturities.push_back(effective_date.add_months(31));
+  maturities.push_back(effective_date.add_years(7).add_days(1));
+
+  for (auto freq_type : {FrequencyTypes::ANNUAL, FrequencyTypes::SEMI_ANNUAL, FrequencyTypes::QUARTERLY}) {
+    auto rates = curve.swap_rates(effective_date, maturities, freq_type);
+    auto again = curve.swap_rates(effective_date, maturities, freq_type);
+    auto day_cc = DayCount(DayCountTypes::THIRTY_E_360);
+    for (size_t j = 0; j < maturities.size(); ++j) {
+      auto flow_dates = Schedule::create(effective_date, maturities[j]).withFreqType(freq_type).get_schedule();
+      flow_dates[0] = effective_date;
+      auto pv01 = 0.0;
+      auto discf = 1.0;
+      for (size_t i = 1; i < flow_dates.size(); ++i) {
+        discf = curve.df(flow_dates[i]);
+        pv01 += std::get<0>(day_cc.year_frac(flow_dates[i - 1], flow_dates[i], FrequencyTypes::ANNUAL)) * discf;
+      }
+      auto expected = (curve.df(effective_date) - discf) / pv01;
+      REQUIRE_THAT(rates[j], Catch::Matchers::WithinRel(expected, 1e-13));
+      REQUIRE(again[j] == rates[j]);
+    }
+  }
 }
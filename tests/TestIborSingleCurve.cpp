@@ -5,6 +5,7 @@
 #include <finproj/curves/IborFuture.h>
 #include <finproj/curves/IborSingleCurve.h>
 #include <iostream>
+#include <optional>
 
 TEST_CASE( "test_ibor_single_curve", "[single-file]" ){
   ChronoDate val_date{2018,6,6};
@@ -182,3 +183,277 @@ TEST_CASE( "test_ibor_again", "[single-file]" ){
   REQUIRE_THAT(actual, Catch::Matchers::WithinAbs(53739.9414, 0.001));
 
 }
+
+namespace {
+
+/** A deposit, six futures and nine swaps, quoted as on 2018-06-06, with the rate of
+instrument bumped, counted in that order, moved by bump */
+struct Market {
+  ChronoDate val_date{2018,6,6};
+  std::vector<IborDeposit> depos{};
+  std::vector<IborFRA> fras{};
+  std::vector<IborSwap> swaps{};
+
+  /** With forward_start the deposit settles with the swaps, so the curve puts a
+  synthetic deposit in front of it. */
+  explicit Market(std::optional<std::size_t> bumped = std::nullopt, double bump = 0.0, bool forward_start = false){
+    std::size_t k{0};
+    auto shift = [&] { return bumped == k++ ? bump : 0.0; };
+    auto settlement_date = val_date.add_weekdays(2);
+    auto depo_start = forward_start ? settlement_date : val_date;
+    depos.emplace_back(depo_start, depo_start.add_months(3), 0.0231381 + shift(), DayCountTypes::ACT_360);
+    std::vector<double> prices{97.6675, 97.5200, 97.3550, 97.2450, 97.1450, 97.0750};
+    std::vector<double> convexities{-0.00005, -0.00060, -0.00146, -0.00263, -0.00411, -0.00589};
+    for (int i{0}; i < 6; ++i)
+      fras.push_back(IborFuture(val_date, i + 1).to_fra(prices[i] - 100.0 * shift(), convexities[i]));
+    std::vector<std::pair<std::string, double>> quotes{{"2Y", 2.776}, {"3Y", 2.863}, {"5Y", 2.929}, {"7Y", 2.957},
+                                                       {"10Y", 3.001}, {"15Y", 3.043}, {"20Y", 3.048}, {"30Y", 3.012},
+                                                       {"50Y", 2.927}};
+    for (auto& [tenor, quote] : quotes)
+      swaps.emplace_back(IborSwap(settlement_date, std::string{tenor}, SwapTypes::PAY, quote / 100 + shift(),
+                                  FrequencyTypes::SEMI_ANNUAL, DayCountTypes::THIRTY_E_360));
+  }
+};
+
+}// namespace
+
+TEST_CASE( "test_ibor_single_curve_newton", "[single-file]" ){
+  Market market{};
+  auto& [val_date, depos, fras, swaps] = market;
+
+  auto num_solved = static_cast<int>(fras.size() + swaps.size());
+  for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::LINEAR_ZERO_RATES}){
+    auto curve = IborSingleCurve(val_date, depos, fras, swaps, interp_type);
+    /** Newton from the extrapolated forward needs a few revaluations per node, where
+    bracketing took a dozen */
+    REQUIRE(curve.solver_evaluations() <= 4 * num_solved);
+    /** FRA end dates fall a little past their nodes on the ACT_ACT_ISDA time axis, so
+    later nodes move them by a few 1e-12 */
+    for (auto& fra : fras)
+      REQUIRE_THAT(fra.value(val_date, curve, curve) / fra.get_notional(), Catch::Matchers::WithinAbs(0.0, 1e-11));
+    for (auto& swap : swaps)
+      REQUIRE_THAT(swap.pv(val_date, curve) / swap.get_notional(), Catch::Matchers::WithinAbs(0.0, 1e-13));
+  }
+}
+
+TEST_CASE( "test_ibor_single_curve_global", "[single-file]" ){
+  Market market{};
+  auto& [val_date, depos, fras, swaps] = market;
+  auto num_nodes = static_cast<Eigen::Index>(depos.size() + fras.size() + swaps.size());
+  for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::LINEAR_ZERO_RATES,
+                           InterpTypes::NATCUBIC_ZERO_RATES, InterpTypes::NATCUBIC_LOG_DISCOUNT,
+                           InterpTypes::PCHIP_ZERO_RATES}){
+    auto curve = IborSingleCurve(val_date, depos, fras, swaps, interp_type, false, BootstrapTypes::GLOBAL);
+    REQUIRE(curve.global_iterations() <= 5);
+    REQUIRE(curve.jacobian().rows() == num_nodes);
+    REQUIRE(curve.jacobian().cols() == num_nodes);
+
+    /** every instrument reprices, also those in front of nodes that move the whole spline */
+    for (auto& dep : depos)
+      REQUIRE_THAT(dep.value(val_date, curve) / dep.get_notional(), Catch::Matchers::WithinAbs(1.0, 1e-14));
+    for (auto& fra : fras)
+      REQUIRE_THAT(fra.value(val_date, curve, curve) / fra.get_notional(), Catch::Matchers::WithinAbs(0.0, 1e-14));
+    for (auto& swap : swaps)
+      REQUIRE_THAT(swap.pv(val_date, curve) / swap.get_notional(), Catch::Matchers::WithinAbs(0.0, 1e-14));
+
+    /** a column of the Jacobian against central differences of the instrument values */
+    Eigen::MatrixXd jacobian(curve.jacobian());
+    auto node = static_cast<std::size_t>(num_nodes - 3);
+    auto h = 1e-7;
+    auto values = [&](double df) {
+      auto bumped = curve;
+      bumped.dfs_[node] = df;
+      bumped.interpolator_.fit(bumped.times_, bumped.dfs_);
+      std::vector<double> out{};
+      for (auto& dep : depos)
+        out.push_back(dep.value(val_date, bumped) / dep.get_notional());
+      for (auto& fra : fras)
+        out.push_back(fra.value(val_date, bumped, bumped) / fra.get_notional());
+      for (auto& swap : swaps)
+        out.push_back(swap.value(val_date, bumped, std::nullopt, std::nullopt) / 1'000'000);
+      return out;
+    };
+    auto up = values(curve.dfs_[node] + h), down = values(curve.dfs_[node] - h);
+    for (Eigen::Index i{0}; i < num_nodes; ++i)
+      REQUIRE_THAT(jacobian(i, static_cast<Eigen::Index>(node) - 1),
+                   Catch::Matchers::WithinAbs((up[i] - down[i]) / (2.0 * h), 1e-6));
+  }
+
+  /** the sequential build of a natural spline leaves the early instruments off */
+  auto sequential = IborSingleCurve(val_date, depos, fras, swaps, InterpTypes::NATCUBIC_ZERO_RATES);
+  REQUIRE(std::fabs(swaps[0].pv(val_date, sequential) / swaps[0].get_notional()) > 1e-8);
+  REQUIRE(sequential.jacobian().size() == 0);
+}
+
+TEST_CASE( "test_ibor_single_curve_quote_sensitivities", "[single-file]" ){
+  for (auto forward_start : {false, true}){
+    Market market{std::nullopt, 0.0, forward_start};
+    auto& [val_date, depos, fras, swaps] = market;
+    auto num_quotes = depos.size() + fras.size() + swaps.size();
+    auto settlement_date = val_date.add_weekdays(2);
+    std::vector<IborSwap> portfolio{
+        IborSwap(settlement_date, "4Y", SwapTypes::RECEIVE, 0.03, FrequencyTypes::SEMI_ANNUAL, DayCountTypes::THIRTY_E_360, 5'000'000),
+        IborSwap(settlement_date, "12Y", SwapTypes::PAY, 0.025, FrequencyTypes::SEMI_ANNUAL, DayCountTypes::THIRTY_E_360, 2'000'000),
+        IborSwap(settlement_date, "25Y", SwapTypes::PAY, 0.031, FrequencyTypes::SEMI_ANNUAL, DayCountTypes::THIRTY_E_360, 1'000'000)};
+
+    for (auto bootstrap_type : {BootstrapTypes::SEQUENTIAL, BootstrapTypes::GLOBAL}){
+      for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::NATCUBIC_ZERO_RATES}){
+        auto curve = IborSingleCurve(val_date, depos, fras, swaps, interp_type, false, bootstrap_type);
+        auto quote_jacobian = curve.quote_jacobian();
+        auto dv01 = curve.bucketed_dv01(portfolio);
+        /** the synthetic deposit adds a node but no quote */
+        REQUIRE(curve.quotes().size() == num_quotes);
+        REQUIRE(quote_jacobian.rows() == static_cast<Eigen::Index>(num_quotes + (forward_start ? 1 : 0)));
+        REQUIRE(quote_jacobian.cols() == static_cast<Eigen::Index>(num_quotes));
+        REQUIRE(dv01.size() == num_quotes);
+
+        /** against rebuilding the curve on central differences of each quote */
+        auto h = 1e-6;
+        auto rebuild = [&](std::size_t k, double bump) {
+          Market bumped_market{k, bump, forward_start};
+          return IborSingleCurve(val_date, bumped_market.depos, bumped_market.fras, bumped_market.swaps,
+                                 interp_type, false, bootstrap_type);
+        };
+        auto portfolio_value = [&](const IborSingleCurve& bumped) {
+          double value{};
+          for (auto swap : portfolio)
+            value += swap.value(val_date, bumped, std::nullopt, std::nullopt);
+          return value;
+        };
+        for (std::size_t k{0}; k < num_quotes; ++k){
+          auto up = rebuild(k, h), down = rebuild(k, -h);
+          auto expected = (portfolio_value(up) - portfolio_value(down)) / (2.0 * h) * 1e-4;
+          REQUIRE_THAT(dv01[k], Catch::Matchers::WithinAbs(expected, 1e-3));
+          for (std::size_t j{1}; j < up.dfs_.size(); ++j)
+            REQUIRE_THAT(quote_jacobian(static_cast<Eigen::Index>(j) - 1, static_cast<Eigen::Index>(k)),
+                         Catch::Matchers::WithinAbs((up.dfs_[j] - down.dfs_[j]) / (2.0 * h), 1e-6));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE( "test_ibor_single_curve_update_quotes", "[single-file]" ){
+  Market market{};
+  auto& [val_date, depos, fras, swaps] = market;
+  auto num_quotes = depos.size() + fras.size() + swaps.size();
+
+  for (auto bootstrap_type : {BootstrapTypes::SEQUENTIAL, BootstrapTypes::GLOBAL}){
+    for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::NATCUBIC_ZERO_RATES}){
+      auto curve = IborSingleCurve(val_date, depos, fras, swaps, interp_type, false, bootstrap_type);
+      auto full_evaluations = curve.solver_evaluations();
+      auto quotes = curve.quotes();
+      REQUIRE(quotes.size() == num_quotes);
+      REQUIRE(quotes[0] == depos[0].get_deposit_rate());
+      REQUIRE(quotes.back() == swaps.back().get_fixed_coupon());
+
+      /** a tick in the 10Y swap, then one in a future and the 30Y swap together */
+      auto ten_years = depos.size() + fras.size() + 4;
+      for (auto ticked : {std::vector<std::size_t>{ten_years}, std::vector<std::size_t>{3, num_quotes - 2}}){
+        for (auto k : ticked)
+          quotes[k] += 0.0003;
+        curve.update_quotes(quotes);
+        auto ticked_depos = depos;
+        auto ticked_fras = fras;
+        auto ticked_swaps = swaps;
+        for (std::size_t k{0}; k < depos.size(); ++k)
+          ticked_depos[k].set_deposit_rate(quotes[k]);
+        for (std::size_t k{0}; k < fras.size(); ++k)
+          ticked_fras[k].set_fra_rate(quotes[depos.size() + k]);
+        for (std::size_t k{0}; k < swaps.size(); ++k)
+          ticked_swaps[k].set_fixed_coupon(quotes[depos.size() + fras.size() + k]);
+        auto rebuilt = IborSingleCurve(val_date, ticked_depos, ticked_fras, ticked_swaps, interp_type, false, bootstrap_type);
+        REQUIRE(curve.dfs_.size() == rebuilt.dfs_.size());
+        for (std::size_t j{0}; j < curve.dfs_.size(); ++j)
+          REQUIRE_THAT(curve.dfs_[j], Catch::Matchers::WithinRel(rebuilt.dfs_[j], 1e-12));
+      }
+      if (bootstrap_type == BootstrapTypes::SEQUENTIAL) {
+        /** only the 10Y node and those after it are solved again, from close by */
+        quotes[ten_years] -= 0.0001;
+        curve.update_quotes(quotes);
+        REQUIRE(curve.solver_evaluations() < full_evaluations / 2);
+      }
+      curve.update_quotes(quotes);
+      REQUIRE(curve.solver_evaluations() == 0);
+    }
+  }
+  auto curve = IborSingleCurve(val_date, depos, fras, swaps);
+  REQUIRE_THROWS_AS(curve.update_quotes(std::vector<double>(num_quotes - 1)), std::runtime_error);
+
+  /** a tick in a forward starting deposit moves the synthetic deposit in front of it */
+  Market forward_market{std::nullopt, 0.0, true};
+  for (auto bootstrap_type : {BootstrapTypes::SEQUENTIAL, BootstrapTypes::GLOBAL}){
+    auto forward_curve = IborSingleCurve(val_date, forward_market.depos, forward_market.fras, forward_market.swaps,
+                                         InterpTypes::FLAT_FWD_RATES, false, bootstrap_type);
+    auto quotes = forward_curve.quotes();
+    REQUIRE(quotes.size() == num_quotes);
+    quotes[0] += 0.0003;
+    forward_curve.update_quotes(quotes);
+    Market ticked_market{0, 0.0003, true};
+    auto rebuilt = IborSingleCurve(val_date, ticked_market.depos, ticked_market.fras, ticked_market.swaps,
+                                   InterpTypes::FLAT_FWD_RATES, false, bootstrap_type);
+    REQUIRE(forward_curve.quotes() == rebuilt.quotes());
+    REQUIRE(forward_curve.dfs_.size() == rebuilt.dfs_.size());
+    for (std::size_t j{0}; j < forward_curve.dfs_.size(); ++j)
+      REQUIRE_THAT(forward_curve.dfs_[j], Catch::Matchers::WithinRel(rebuilt.dfs_[j], 1e-12));
+  }
+}
+
+TEST_CASE( "test_cashflow_plan", "[single-file]" ){
+  Market market{};
+  auto& [val_date, depos, fras, swaps] = market;
+  auto curve = IborSingleCurve(val_date, depos, fras, swaps, InterpTypes::FLAT_FWD_RATES);
+  for (auto& dep : depos)
+    REQUIRE_THAT(dep.cashflow_plan(val_date, curve).pv(curve),
+                 Catch::Matchers::WithinRel(dep.value(val_date, curve), 1e-13));
+  for (auto& fra : fras)
+    REQUIRE_THAT(fra.cashflow_plan(val_date, curve).pv(curve),
+                 Catch::Matchers::WithinAbs(fra.value(val_date, curve, curve), 1e-10));
+  auto settlement_date = val_date.add_days(2);
+  for (auto& swap : swaps){
+    REQUIRE_THAT(swap.cashflow_plan(val_date, curve).pv(curve),
+                 Catch::Matchers::WithinAbs(swap.pv(val_date, curve), 1e-6));
+    REQUIRE_THAT(swap.cashflow_plan(settlement_date, curve, 0.02).pv(curve),
+                 Catch::Matchers::WithinAbs(swap.pv(settlement_date, curve, curve, 0.02), 1e-6));
+  }
+
+  /** the kernel's derivatives against central differences on bumped nodes, for plans
+  anchored at the deposit start and at the valuation date */
+  const double h = 1e-7;
+  auto bumped_pv = [&](const CashflowPlan& plan, std::size_t node, double bump) {
+    auto bumped = curve;
+    bumped.dfs_[node] += bump;
+    bumped.interpolator_.fit(bumped.times_, bumped.dfs_);
+    return plan.pv(bumped);
+  };
+  auto& swap = swaps.back();
+  for (auto [plan, notional] : {std::pair{depos[0].cashflow_plan(val_date, curve), depos[0].get_notional()},
+                                std::pair{fras[3].cashflow_plan(val_date, curve), fras[3].get_notional()},
+                                std::pair{swap.cashflow_plan(val_date, curve), swap.get_notional()}}){
+    plan.scale(1.0 / notional);
+    auto last = curve.dfs_.size() - 1;
+    auto [value, derivative] = plan.value_and_last_node_sensitivity(curve);
+    REQUIRE_THAT(value, Catch::Matchers::WithinAbs(plan.pv(curve), 1e-12));
+    REQUIRE_THAT(derivative, Catch::Matchers::WithinAbs((bumped_pv(plan, last, h) - bumped_pv(plan, last, -h)) / (2.0 * h), 1e-6));
+    std::vector<double> grad(curve.dfs_.size()), work(curve.dfs_.size());
+    REQUIRE_THAT(plan.value_and_node_sensitivities(curve, grad, work), Catch::Matchers::WithinAbs(value, 1e-12));
+    for (std::size_t j{1}; j < grad.size(); ++j)
+      REQUIRE_THAT(grad[j], Catch::Matchers::WithinAbs((bumped_pv(plan, j, h) - bumped_pv(plan, j, -h)) / (2.0 * h), 1e-6));
+  }
+
+  /** the cashflows a move of the last node leaves alone are a head valued once */
+  auto plan = swap.cashflow_plan(val_date, curve);
+  plan.scale(1.0 / swap.get_notional());
+  auto first = plan.first_after(curve.times_[curve.times_.size() - 2]);
+  REQUIRE(first > 0);
+  REQUIRE(first < plan.cashflows().size());
+  auto head = plan.head_value(curve, first);
+  for (auto bump : {-1e-3, 0.0, 1e-3}){
+    auto bumped = curve;
+    bumped.interpolator_.set_last_value(curve.dfs_.back() + bump);
+    auto [full_value, full_derivative] = plan.value_and_last_node_sensitivity(bumped);
+    auto [split_value, split_derivative] = plan.value_and_last_node_sensitivity(bumped, first, head);
+    REQUIRE_THAT(split_value, Catch::Matchers::WithinAbs(full_value, 1e-14));
+    REQUIRE_THAT(split_derivative, Catch::Matchers::WithinRel(full_derivative, 1e-12));
+  }
+}
@@ -237,3 +237,64 @@ TEST_CASE( "test_LiborSwap", "[single-file]" ){
   REQUIRE_THAT(v, Catch::Matchers::WithinAbs(318901.4791, 0.0001));
 }
 
+
+TEST_CASE( "test_ibor_swap_cashflow_report", "[single-file]" ){
+  ChronoDate valuation_date{2018,11,30};
+  auto settlement_date = valuation_date.add_days(2);
+  auto libor_curve = build_ibor_curve(valuation_date);
+  auto swap = IborSwap(ChronoDate{2017,12,27}, ChronoDate{2067,12,27}, SwapTypes::RECEIVE, 0.015,
+                       FrequencyTypes::ANNUAL, DayCountTypes::THIRTY_E_360, 10.0 * 1'000'000, 0.0,
+                       FrequencyTypes::SEMI_ANNUAL, DayCountTypes::ACT_360);
+  auto fixed_leg = swap.get_fixed_leg();
+  auto float_leg = swap.get_double_leg();
+
+  CashflowReport report{};
+  auto fixed_pv = fixed_leg.cashflow_report(settlement_date, libor_curve, report);
+  REQUIRE_THAT(fixed_pv, Catch::Matchers::WithinAbs(fixed_leg.pv(settlement_date, libor_curve), 1e-6));
+  REQUIRE_THAT(report.cumulative_pvs.back(), Catch::Matchers::WithinAbs(fixed_pv, 1e-6));
+  double sum{};
+  for (auto payment_pv : report.payment_pvs)
+    sum += payment_pv;
+  REQUIRE_THAT(sum, Catch::Matchers::WithinAbs(fixed_pv, 1e-6));
+
+  /** the longer float schedule grows the report once, revaluing reuses its storage */
+  auto float_pv = float_leg.cashflow_report(settlement_date, libor_curve, libor_curve, -0.00268, report);
+  REQUIRE_THAT(float_pv, Catch::Matchers::WithinAbs(float_leg.pv(settlement_date, libor_curve, libor_curve, -0.00268), 1e-6));
+  REQUIRE_THAT(-report.cumulative_pvs.back(), Catch::Matchers::WithinAbs(float_pv, 1e-6));
+  const auto* rates = report.rates.data();
+  float_leg.cashflow_report(settlement_date, libor_curve, libor_curve, std::nullopt, report);
+  fixed_leg.cashflow_report(settlement_date, libor_curve, report);
+  REQUIRE(report.rates.data() == rates);
+
+  REQUIRE_THAT(swap.pv(settlement_date, libor_curve, libor_curve, -0.00268),
+               Catch::Matchers::WithinAbs(fixed_pv + float_pv, 1e-6));
+}
+
+TEST_CASE( "test_swap_float_leg_principal", "[single-file]" ){
+  ChronoDate valuation_date{2018,11,30};
+  auto settlement_date = valuation_date.add_days(2);
+  auto libor_curve = build_ibor_curve(valuation_date);
+  auto notional = 10.0 * 1'000'000;
+  ChronoDate eff_date{2017,12,27}, termination_date{2027,12,27};
+  auto float_leg = SwapFloatLeg(eff_date, termination_date, SwapTypes::PAY, 0.001, FrequencyTypes::SEMI_ANNUAL,
+                                DayCountTypes::ACT_360, notional, 1.0);
+  auto no_principal_leg = SwapFloatLeg(eff_date, termination_date, SwapTypes::PAY, 0.001, FrequencyTypes::SEMI_ANNUAL,
+                                       DayCountTypes::ACT_360, notional, 0.0);
+
+  auto pv = float_leg.pv(settlement_date, libor_curve, libor_curve, -0.00268);
+  CashflowReport report{};
+  REQUIRE_THAT(float_leg.cashflow_report(settlement_date, libor_curve, libor_curve, -0.00268, report),
+               Catch::Matchers::WithinAbs(pv, 1e-6));
+
+  /** the principal is paid with the last coupon */
+  auto principal_pv = -notional * libor_curve.df(report.payment_dates.back()) / libor_curve.df(settlement_date);
+  REQUIRE_THAT(pv - no_principal_leg.pv(settlement_date, libor_curve, libor_curve, -0.00268),
+               Catch::Matchers::WithinAbs(principal_pv, 1e-6));
+
+  std::vector<PlannedCashflow> cashflows{};
+  float_leg.append_cashflows(settlement_date, libor_curve, -0.00268, cashflows);
+  double anchor_time{};
+  libor_curve.times(std::span{&settlement_date, 1}, std::span{&anchor_time, 1});
+  CashflowPlan plan{anchor_time, std::move(cashflows)};
+  REQUIRE_THAT(plan.pv(libor_curve), Catch::Matchers::WithinAbs(pv, 1e-6));
+}
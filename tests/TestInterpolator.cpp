@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include "finproj/utils/Interpolator.h"
+#include "finproj/utils/UniformLookup.h"
 #include "finproj/utils/Misc.h"
 #include <vector>
 #include <cmath>
@@ -114,3 +115,156 @@ TEST_CASE( "test_FINCUBIC_ZERO_RATES", "[single-file]" ){
   REQUIRE_THAT(y_int,Catch::Matchers::WithinAbs(0.6007, 0.01));
 
 }
+
+TEST_CASE( "test_interpolate_with_hint", "[single-file]" ){
+  for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::LINEAR_FWD_RATES, InterpTypes::LINEAR_ZERO_RATES}){
+    Interpolator interpolator{xValues,yValues,interp_type};
+    std::size_t hint{0};
+    for (auto x : xInterpolateValues){
+      REQUIRE(interpolator.interpolate(x, hint) == interpolator.interpolate(x));
+    }
+  }
+}
+
+TEST_CASE( "test_interpolate_batch", "[single-file]" ){
+  for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::LINEAR_FWD_RATES,
+                           InterpTypes::LINEAR_ZERO_RATES, InterpTypes::FINCUBIC_ZERO_RATES}){
+    Interpolator interpolator{xValues,yValues,interp_type};
+    std::vector<double> y_int(xInterpolateValues.size());
+    interpolator.interpolate(xInterpolateValues, y_int);
+    for (size_t i{0}; i < xInterpolateValues.size(); ++i){
+      REQUIRE_THAT(y_int[i],Catch::Matchers::WithinRel(interpolator.interpolate(xInterpolateValues[i]), 1e-14));
+    }
+  }
+}
+
+TEST_CASE( "test_spline_types", "[single-file]" ){
+  for (auto interp_type : {InterpTypes::NATCUBIC_LOG_DISCOUNT, InterpTypes::NATCUBIC_ZERO_RATES,
+                           InterpTypes::PCHIP_LOG_DISCOUNT, InterpTypes::PCHIP_ZERO_RATES}){
+    Interpolator interpolator{xValues,yValues,interp_type};
+    for (size_t i{0}; i < xValues.size(); ++i){
+      REQUIRE_THAT(interpolator.interpolate(xValues[i]),Catch::Matchers::WithinRel(yValues[i], 1e-9));
+    }
+    for (auto index : {1, 6, 11}){
+      auto x = xInterpolateValues[index];
+      REQUIRE_THAT(interpolator.interpolate(x),Catch::Matchers::WithinAbs(exp(a * x + b * x * x), 0.001));
+    }
+  }
+}
+
+TEST_CASE( "test_set_last_value", "[single-file]" ){
+  for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::LINEAR_FWD_RATES,
+                           InterpTypes::LINEAR_ZERO_RATES, InterpTypes::FINCUBIC_ZERO_RATES,
+                           InterpTypes::NATCUBIC_LOG_DISCOUNT, InterpTypes::NATCUBIC_ZERO_RATES,
+                           InterpTypes::PCHIP_LOG_DISCOUNT, InterpTypes::PCHIP_ZERO_RATES}){
+    Interpolator interpolator{xValues,yValues,interp_type};
+    auto bumped = yValues;
+    bumped.back() *= 0.98;
+    interpolator.set_last_value(bumped.back());
+    Interpolator refitted{xValues,bumped,interp_type};
+    for (auto x : xInterpolateValues){
+      REQUIRE_THAT(interpolator.interpolate(x),Catch::Matchers::WithinRel(refitted.interpolate(x), 1e-14));
+    }
+  }
+}
+
+TEST_CASE( "test_basic_interpolator_policies", "[single-file]" ){
+  BasicInterpolator<FlatFwd> flat{xValues,yValues};
+  BasicInterpolator<LinearZero> linear_zero{xValues,yValues};
+  BasicInterpolator<CubicLog> pchip_log{xValues,yValues,InterpTypes::PCHIP_LOG_DISCOUNT};
+  Interpolator flat_erased{xValues,yValues,InterpTypes::FLAT_FWD_RATES};
+  Interpolator linear_zero_erased{xValues,yValues,InterpTypes::LINEAR_ZERO_RATES};
+  Interpolator pchip_log_erased{xValues,yValues,InterpTypes::PCHIP_LOG_DISCOUNT};
+  for (auto x : xInterpolateValues){
+    REQUIRE(flat.interpolate(x) == flat_erased.interpolate(x));
+    REQUIRE(linear_zero.interpolate(x) == linear_zero_erased.interpolate(x));
+    REQUIRE(pchip_log.interpolate(x) == pchip_log_erased.interpolate(x));
+  }
+  REQUIRE_THROWS(BasicInterpolator<FlatFwd>{xValues,yValues,InterpTypes::LINEAR_FWD_RATES});
+}
+
+TEST_CASE( "test_push_and_pop_node", "[single-file]" ){
+  for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::LINEAR_FWD_RATES,
+                           InterpTypes::LINEAR_ZERO_RATES, InterpTypes::FINCUBIC_ZERO_RATES,
+                           InterpTypes::NATCUBIC_LOG_DISCOUNT, InterpTypes::PCHIP_ZERO_RATES}){
+    Interpolator interpolator{interp_type};
+    interpolator.reserve(xValues.size());
+    for (size_t i{0}; i < xValues.size(); ++i){
+      interpolator.push_node(xValues[i], yValues[i]);
+    }
+    Interpolator refitted{xValues,yValues,interp_type};
+    for (auto x : xInterpolateValues){
+      REQUIRE_THAT(interpolator.interpolate(x),Catch::Matchers::WithinRel(refitted.interpolate(x), 1e-14));
+    }
+    interpolator.pop_node();
+    interpolator.pop_node();
+    std::vector<double> xs(xValues.begin(), xValues.end() - 2), ys(yValues.begin(), yValues.end() - 2);
+    refitted.fit(xs, ys);
+    for (auto x : xInterpolateValues){
+      REQUIRE_THAT(interpolator.interpolate(x),Catch::Matchers::WithinRel(refitted.interpolate(x), 1e-14));
+    }
+    REQUIRE_THROWS(interpolator.push_node(xs.back(), 0.9));
+  }
+}
+
+TEST_CASE( "test_uniform_lookup", "[single-file]" ){
+  for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::NATCUBIC_LOG_DISCOUNT}){
+    Interpolator interpolator{xValues,yValues,interp_type};
+    auto lookup = UniformLookup::sample(interpolator, 10.0, 3651, xValues);
+    REQUIRE(lookup.max_error() < 1e-5);
+    for (auto x : linspace(0.0, 10.0, 997)){
+      auto exact = interpolator.interpolate(x);
+      REQUIRE(fabs(lookup.interpolate(x) / exact - 1.0) <= lookup.max_error() * (1.0 + 1e-9) + 1e-15);
+    }
+  }
+}
+
+TEST_CASE( "test_forward_and_node_sensitivities", "[single-file]" ){
+  std::vector<double> times{0.0, 0.25, 0.5, 0.75, 1.0, 2.0, 3.0, 5.0, 10.0};
+  std::vector<double> dfs{1.0};
+  for (auto t : xValues){
+    dfs.push_back(exp(a * t + b * t * t));
+  }
+  for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::LINEAR_FWD_RATES,
+                           InterpTypes::LINEAR_ZERO_RATES, InterpTypes::FINCUBIC_ZERO_RATES,
+                           InterpTypes::NATCUBIC_LOG_DISCOUNT, InterpTypes::NATCUBIC_ZERO_RATES,
+                           InterpTypes::PCHIP_LOG_DISCOUNT, InterpTypes::PCHIP_ZERO_RATES}){
+    Interpolator interpolator{times,dfs,interp_type};
+    std::vector<double> sens(dfs.size());
+    auto h = 1e-6;
+    for (auto x : {0.1, 0.6, 1.7, 4.0, 9.5, 12.0}){
+      auto fd_fwd = log(interpolator.interpolate(x - h) / interpolator.interpolate(x + h)) / (2.0 * h);
+      REQUIRE_THAT(interpolator.forward(x),Catch::Matchers::WithinAbs(fd_fwd, 1e-7));
+      REQUIRE_THAT(interpolator.derivative(x),Catch::Matchers::WithinAbs(-fd_fwd * interpolator.interpolate(x), 1e-7));
+      interpolator.node_sensitivities(x, sens);
+      for (size_t j{1}; j < dfs.size(); ++j){
+        auto up = dfs, down = dfs;
+        up[j] += 1e-8;
+        down[j] -= 1e-8;
+        auto fd = (Interpolator{times,up,interp_type}.interpolate(x) -
+                   Interpolator{times,down,interp_type}.interpolate(x)) / 2e-8;
+        REQUIRE_THAT(sens[j],Catch::Matchers::WithinAbs(fd, 1e-6));
+      }
+    }
+  }
+}
+
+TEST_CASE( "test_last_exponent_gradient", "[single-file]" ){
+  std::vector<double> times{0.0, 0.25, 0.5, 0.75, 1.0, 2.0, 3.0, 5.0, 10.0};
+  std::vector<double> dfs{1.0};
+  for (auto t : xValues){
+    dfs.push_back(exp(a * t + b * t * t));
+  }
+  for (auto interp_type : {InterpTypes::FLAT_FWD_RATES, InterpTypes::LINEAR_ZERO_RATES,
+                           InterpTypes::LINEAR_FWD_RATES, InterpTypes::NATCUBIC_ZERO_RATES}){
+    /** the first node alone, then the node after the origin, then the full curve */
+    for (size_t n : {size_t{2}, size_t{3}, times.size()}){
+      SegmentTable table{{times.begin(), times.begin() + n}, {dfs.begin(), dfs.begin() + n}, interp_type};
+      std::vector<double> grad(n);
+      for (auto x : {0.1, 0.3, 0.6, 1.7, 4.0, 9.5, 12.0}){
+        table.exponent_gradient(x, grad);
+        REQUIRE_THAT(table.last_exponent_gradient(x), Catch::Matchers::WithinAbs(grad.back(), 1e-14));
+      }
+    }
+  }
+}
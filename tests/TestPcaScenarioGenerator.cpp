@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <finproj/models/PcaScenarioGenerator.h>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+TEST_CASE( "test_pca_scenario_generator", "[single-file]" ){
+  std::vector<double> times{0.5, 1.0, 2.0, 3.0, 5.0, 7.0, 10.0, 15.0, 20.0, 30.0};
+  auto num_nodes = static_cast<Eigen::Index>(times.size());
+  /** daily changes driven by level, slope and curvature factors plus a little noise */
+  std::mt19937_64 engine(7);
+  std::normal_distribution<> nd;
+  Eigen::MatrixXd history(500, num_nodes);
+  Eigen::RowVectorXd curve(num_nodes);
+  for (Eigen::Index j{0}; j < num_nodes; ++j)
+    curve(j) = 0.02 + 0.01 * (1.0 - std::exp(-times[j] / 5.0));
+  for (Eigen::Index i{0}; i < history.rows(); ++i) {
+    auto level = 0.0005 * nd(engine), slope = 0.0003 * nd(engine), bend = 0.0001 * nd(engine);
+    for (Eigen::Index j{0}; j < num_nodes; ++j) {
+      auto x = times[j] / 30.0;
+      curve(j) += level + slope * (x - 0.5) + bend * (x - 0.5) * (x - 0.5) + 0.000001 * nd(engine);
+    }
+    history.row(i) = curve;
+  }
+
+  PcaScenarioGenerator generator(times, history, 3);
+  REQUIRE(generator.explained_variance() > 0.999);
+  REQUIRE(generator.eigenvalues()(0) > generator.eigenvalues()(1));
+  REQUIRE(generator.eigenvalues()(1) > generator.eigenvalues()(2));
+  Eigen::MatrixXd gram = generator.components().transpose() * generator.components();
+  REQUIRE(gram.isIdentity(1e-12));
+
+  Eigen::VectorXd base = history.row(history.rows() - 1).transpose();
+  auto cube = generator.generate(base, 20000, 42, 10.0, InterpTypes::FLAT_FWD_RATES, 4);
+  REQUIRE(cube.num_scenarios() == 20000);
+  REQUIRE(cube.num_nodes() == num_nodes);
+
+  /** the same seed gives the same scenarios whatever the thread count */
+  auto serial = generator.generate(base, 20000, 42, 10.0, InterpTypes::FLAT_FWD_RATES, 1);
+  REQUIRE(cube.dfs() == serial.dfs());
+  auto other = generator.generate(base, 20000, 43, 10.0, InterpTypes::FLAT_FWD_RATES, 4);
+  REQUIRE(cube.dfs() != other.dfs());
+
+  /** recover the zero rates and check their moments against the kept factors */
+  Eigen::MatrixXd zeros = -cube.dfs().array().log().matrix();
+  for (Eigen::Index j{0}; j < num_nodes; ++j)
+    zeros.col(j) /= times[j];
+  Eigen::RowVectorXd mean = zeros.colwise().mean();
+  Eigen::MatrixXd centered = zeros.rowwise() - mean;
+  Eigen::MatrixXd covariance = centered.transpose() * centered / static_cast<double>(zeros.rows() - 1);
+  Eigen::MatrixXd expected = 10.0 * generator.components() * generator.eigenvalues().asDiagonal() *
+                             generator.components().transpose();
+  for (Eigen::Index j{0}; j < num_nodes; ++j) {
+    REQUIRE_THAT(mean(j), Catch::Matchers::WithinAbs(base(j), 1e-4));
+    REQUIRE_THAT(covariance(j, j), Catch::Matchers::WithinRel(expected(j, j), 0.05));
+  }
+  REQUIRE_THROWS_AS(PcaScenarioGenerator(times, history, 11), std::runtime_error);
+  auto unsorted = times;
+  std::swap(unsorted[2], unsorted[3]);
+  REQUIRE_THROWS_AS(PcaScenarioGenerator(unsorted, history, 3), std::runtime_error);
+  auto from_zero = times;
+  from_zero[0] = 0.0;
+  REQUIRE_THROWS_AS(PcaScenarioGenerator(from_zero, history, 3), std::runtime_error);
+}
+
+TEST_CASE( "test_pca_scenarios_from_curves", "[single-file]" ){
+  ChronoDate curve_date{2018,12,20};
+  std::vector<IborSingleCurve> history{};
+  for (int day{0}; day < 4; ++day) {
+    std::vector<IborDeposit> depos{};
+    std::vector<IborFRA> fras{};
+    std::vector<IborSwap> swaps{};
+    for (int i{1}; i < 11; ++i)
+      swaps.emplace_back(IborSwap(curve_date, curve_date.add_months(12 * i), SwapTypes::PAY,
+                                  0.03 + 0.001 * i + 0.0002 * day * (day % 2 == 0 ? 1 : -1) * i,
+                                  FrequencyTypes::SEMI_ANNUAL, DayCountTypes::ACT_365F));
+    history.emplace_back(curve_date, depos, fras, swaps);
+  }
+  std::vector<double> times{1.0, 2.0, 5.0, 10.0};
+  PcaScenarioGenerator generator(times, history, 2);
+  auto base = PcaScenarioGenerator::zero_rates(history.back(), times);
+  for (std::size_t j{0}; j < times.size(); ++j)
+    REQUIRE_THAT(std::exp(-base(static_cast<Eigen::Index>(j)) * times[j]),
+                 Catch::Matchers::WithinRel(history.back().df(times[j]), 1e-14));
+  auto cube = generator.generate(history.back(), 100, 1);
+  REQUIRE(cube.num_scenarios() == 100);
+  REQUIRE(cube.times() == times);
+}
@@ -0,0 +1,82 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <finproj/curves/SharedCurves.h>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "TestCurves.h"
+
+TEST_CASE( "test_shared_curves", "[single-file]" ){
+  auto name = "/finproj_test_" + std::to_string(::getpid());
+  ChronoDate curve_date{2018,12,20};
+  auto [libor_curve, issuer_curve] = swap_and_cds_curves(curve_date);
+
+  SharedCurvePublisher publisher(name, 1 << 16);
+  SharedCurveReader reader(name);
+  REQUIRE(reader.generation() == 0);
+  REQUIRE_THROWS_AS(reader.read([](auto, auto) { return 0; }), std::runtime_error);
+
+  CurveSnapshotWriter writer{};
+  writer.add(libor_curve, "libor");
+  writer.add(issuer_curve);
+  REQUIRE(publisher.publish(writer) == 1);
+  reader.read([&](std::span<const CurveView> views, std::uint64_t generation) {
+    REQUIRE(generation == 1);
+    REQUIRE(views.size() == 2);
+    REQUIRE(views[1].ticker() == "XYZ");
+    for (int i{1}; i < 40; ++i) {
+      auto date = curve_date.add_months(3 * i);
+      REQUIRE(views[0].df(date) == libor_curve.df(date));
+      REQUIRE(views[1].surv_prob(date) == issuer_curve.surv_prob(date));
+    }
+    return 0;
+  });
+
+  CurveSnapshotWriter too_large{};
+  for (int i{0}; i < 200; ++i)
+    too_large.add(libor_curve, "libor");
+  REQUIRE_THROWS_AS(publisher.publish(too_large), std::runtime_error);
+  REQUIRE(reader.generation() == 1);
+
+  /** readers racing a fast publisher only ever see curves of one generation together */
+  const std::uint64_t last_generation = 2000;
+  std::atomic<bool> done{false};
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> readers{};
+  for (int r{0}; r < 2; ++r) {
+    readers.emplace_back([&] {
+      SharedCurveReader own_reader(name);
+      std::uint64_t last_seen{0};
+      while (!done.load()) {
+        auto consistent = own_reader.read([&](std::span<const CurveView> views, std::uint64_t generation) {
+          if (generation == 1)
+            return true;
+          auto expected = std::exp(-0.0001 * static_cast<double>(generation) * 5.0);
+          auto ok = generation >= last_seen && views.size() == 2;
+          for (const auto& view : views)
+            ok = ok && std::fabs(view.df(5.0) - expected) < 1e-14;
+          last_seen = generation;
+          return ok;
+        });
+        if (!consistent)
+          ++mismatches;
+      }
+    });
+  }
+  for (std::uint64_t g{2}; g <= last_generation; ++g) {
+    CurveSnapshotWriter next{};
+    next.add(flat_curve(curve_date, g), "libor");
+    next.add(flat_curve(curve_date, g), "ois");
+    REQUIRE(publisher.publish(next) == g);
+  }
+  done = true;
+  for (auto& thread : readers)
+    thread.join();
+  REQUIRE(mismatches == 0);
+  REQUIRE(reader.generation() == last_generation);
+
+  SharedCurvePublisher::unlink(name);
+  REQUIRE_THROWS_AS(SharedCurveReader(name), std::runtime_error);
+}
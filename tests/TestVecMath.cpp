@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "finproj/utils/VecMath.h"
+#include <vector>
+#include <cmath>
+#include <limits>
+
+template <class T>
+std::vector<T> spread(T lo, T hi, std::size_t n){
+  std::vector<T> x(n);
+  for (std::size_t i{0}; i < n; ++i)
+    x[i] = lo + (hi - lo) * static_cast<T>(i) / static_cast<T>(n - 1);
+  return x;
+}
+
+TEST_CASE( "test_vecmath_double", "[single-file]" ){
+  // odd lengths run through the padded tail block as well
+  auto x = spread(-700.0, 700.0, 10001);
+  std::vector<double> y(x.size());
+  vecmath::exp(x, y);
+  for (std::size_t i{0}; i < x.size(); ++i)
+    REQUIRE_THAT(y[i], Catch::Matchers::WithinULP(std::exp(x[i]), 4));
+
+  auto p = spread(1e-6, 50.0, 10001);
+  vecmath::log(p, y);
+  for (std::size_t i{0}; i < p.size(); ++i)
+    REQUIRE_THAT(y[i], Catch::Matchers::WithinULP(std::log(p[i]), 4));
+
+  auto s = spread(-3.0, 3.0, 10001);
+  vecmath::expm1(s, y);
+  for (std::size_t i{0}; i < s.size(); ++i)
+    REQUIRE_THAT(y[i], Catch::Matchers::WithinULP(std::expm1(s[i]), 4));
+
+  vecmath::exp_neg(x);
+  for (std::size_t i{0}; i < x.size(); ++i)
+    REQUIRE_THAT(x[i], Catch::Matchers::WithinULP(std::exp(-(-700.0 + 1400.0 * static_cast<double>(i) / 10000.0)), 4));
+}
+
+TEST_CASE( "test_vecmath_float", "[single-file]" ){
+  auto x = spread(-80.0f, 80.0f, 1001);
+  std::vector<float> y(x.size());
+  vecmath::exp(x, y);
+  for (std::size_t i{0}; i < x.size(); ++i)
+    REQUIRE_THAT(y[i], Catch::Matchers::WithinULP(std::exp(x[i]), 4));
+
+  auto p = spread(1e-3f, 50.0f, 1001);
+  vecmath::log(p, y);
+  for (std::size_t i{0}; i < p.size(); ++i)
+    REQUIRE_THAT(y[i], Catch::Matchers::WithinULP(std::log(p[i]), 4));
+
+  auto s = spread(-3.0f, 3.0f, 1001);
+  vecmath::expm1(s, s);
+  for (std::size_t i{0}; i < s.size(); ++i)
+    REQUIRE_THAT(s[i], Catch::Matchers::WithinULP(std::expm1(-3.0f + 6.0f * static_cast<float>(i) / 1000.0f), 4));
+}
+
+TEST_CASE( "test_vecmath_special_values", "[single-file]" ){
+  const auto inf = std::numeric_limits<double>::infinity();
+  std::vector<double> x{0.0, 1.0, -1.0, inf, -inf, 800.0, -800.0, 1e-310, 2.0};
+  std::vector<double> y(x.size());
+  vecmath::exp(x, y);
+  for (std::size_t i{0}; i < x.size(); ++i)
+    REQUIRE(y[i] == std::exp(x[i]));
+  vecmath::expm1(x, y);
+  for (std::size_t i{0}; i < x.size(); ++i)
+    REQUIRE(y[i] == std::expm1(x[i]));
+  vecmath::log(x, y);
+  REQUIRE(y[0] == -inf);
+  REQUIRE(y[1] == 0.0);
+  REQUIRE(std::isnan(y[2]));
+  REQUIRE(y[3] == inf);
+  REQUIRE(y[7] == std::log(1e-310));
+  REQUIRE_THROWS(vecmath::log(x, std::span(y).first(3)));
+}